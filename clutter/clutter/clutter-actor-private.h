@@ -262,7 +262,8 @@ gboolean                        _clutter_actor_set_default_paint_volume
 
 const gchar *                   _clutter_actor_get_debug_name                           (ClutterActor *self);
 
-void                            _clutter_actor_push_clone_paint                         (void);
+void                            _clutter_actor_push_clone_paint                         (ClutterActor *clone,
+                                                                                         ClutterActor *source);
 void                            _clutter_actor_pop_clone_paint                          (void);
 
 void                            _clutter_actor_shader_pre_paint                         (ClutterActor *actor,
@@ -293,6 +294,19 @@ void clutter_actor_update_stage_views (ClutterActor *self,
 
 void clutter_actor_queue_immediate_relayout (ClutterActor *self);
 
+gboolean _clutter_actor_interpolate_animatable_property (ClutterActor    *self,
+                                                         GParamSpec      *pspec,
+                                                         ClutterInterval *interval,
+                                                         double           progress);
+
+void _clutter_actor_begin_animation_batch (void);
+void _clutter_actor_end_animation_batch (void);
+
+void _clutter_actor_get_size_request_cache_stats (unsigned int *hits,
+                                                  unsigned int *misses);
+
+gboolean _clutter_actor_allocate_relayout_boundary (ClutterActor *self);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_ACTOR_PRIVATE_H__ */
@@ -640,6 +640,7 @@
 #include "clutter-fixed-layout.h"
 #include "clutter-flatten-effect.h"
 #include "clutter-interval.h"
+#include "clutter-interval-private.h"
 #include "clutter-main.h"
 #include "clutter-marshal.h"
 #include "clutter-mutter.h"
@@ -681,6 +682,87 @@ typedef enum
  * will ask for 3 different preferred size in each allocation cycle */
 #define N_CACHED_SIZE_REQUESTS 3
 
+/* Actors measured against more different sizes than that, like the
+ * children of a ClutterGridLayout or a ClutterFlowLayout, keep the entries
+ * evicted from the arrays above in a larger hashed cache; its size can be
+ * changed with the CLUTTER_SIZE_REQUEST_CACHE_SIZE environment variable,
+ * or set to 0 to disable it.
+ */
+#define DEFAULT_SIZE_REQUEST_CACHE_SIZE 32
+
+typedef struct _SizeRequestCache
+{
+  /* Entries are only valid if their age matches the generation, which
+   * gets bumped whenever the size requests are invalidated
+   */
+  guint generation;
+
+  SizeRequest *width_requests;
+  SizeRequest *height_requests;
+} SizeRequestCache;
+
+static int size_request_cache_size = -1;
+static unsigned int size_request_cache_hits = 0;
+static unsigned int size_request_cache_misses = 0;
+
+static unsigned int
+get_size_request_cache_size (void)
+{
+  if (G_UNLIKELY (size_request_cache_size < 0))
+    {
+      const char *env_string;
+      guint64 size = DEFAULT_SIZE_REQUEST_CACHE_SIZE;
+
+      env_string = g_getenv ("CLUTTER_SIZE_REQUEST_CACHE_SIZE");
+      if (env_string != NULL)
+        size = MIN (g_ascii_strtoull (env_string, NULL, 10), 4096);
+
+      /* entries are indexed by masking the hash */
+      size_request_cache_size = 0;
+      if (size > 0)
+        {
+          size_request_cache_size = 1;
+          while (size_request_cache_size < size)
+            size_request_cache_size <<= 1;
+        }
+    }
+
+  return size_request_cache_size;
+}
+
+/* What the layout of the parent depends on, as of the last time the
+ * parent allocated the actor; all fields are 32 bits wide so that two
+ * states can be compared with memcmp()
+ */
+typedef struct _LayoutState
+{
+  float min_width;
+  float natural_width;
+  float min_height;
+  float natural_height;
+
+  graphene_point_t fixed_pos;
+  ClutterMargin margin;
+
+  guint x_align;
+  guint y_align;
+  guint x_expand;
+  guint y_expand;
+
+  guint flags;
+} LayoutState;
+
+enum
+{
+  LAYOUT_STATE_VISIBLE        = 1 << 0,
+  LAYOUT_STATE_POSITION_SET   = 1 << 1,
+  LAYOUT_STATE_X_EXPAND_SET   = 1 << 2,
+  LAYOUT_STATE_Y_EXPAND_SET   = 1 << 3,
+  LAYOUT_STATE_NEEDS_X_EXPAND = 1 << 4,
+  LAYOUT_STATE_NEEDS_Y_EXPAND = 1 << 5,
+  LAYOUT_STATE_COMPUTE_EXPAND = 1 << 6,
+};
+
 struct _ClutterActorPrivate
 {
   /* request mode */
@@ -689,6 +771,13 @@ struct _ClutterActorPrivate
   /* our cached size requests for different width / height */
   SizeRequest width_requests[N_CACHED_SIZE_REQUESTS];
   SizeRequest height_requests[N_CACHED_SIZE_REQUESTS];
+  SizeRequestCache *size_request_cache;
+
+  /* the box our parent last allocated us with, before constraints and
+   * alignment were applied; see clutter_actor_is_relayout_boundary()
+   */
+  ClutterActorBox allocation_request;
+  LayoutState *layout_state;
 
   /* An age of 0 means the entry is not set */
   guint cached_height_age;
@@ -787,6 +876,11 @@ struct _ClutterActorPrivate
    */
   ClutterPaintVolume last_paint_volume;
 
+  /* last_paint_volume projected on the stage, for culling against the
+   * redraw clip; only valid while last_paint_volume_current is set
+   */
+  ClutterActorBox last_paint_box;
+
   ClutterStageQueueRedrawEntry *queue_redraw_entry;
 
   ClutterColor bg_color;
@@ -839,6 +933,12 @@ struct _ClutterActorPrivate
   guint propagated_one_redraw       : 1;
   guint paint_volume_valid          : 1;
   guint last_paint_volume_valid     : 1;
+  /* whether last_paint_volume still matches the current paint volume
+   * and transformation, so it can be reused when painting other views
+   * and when picking
+   */
+  guint last_paint_volume_current   : 1;
+  guint last_paint_box_valid        : 1;
   guint in_clone_paint              : 1;
   guint transform_valid             : 1;
   /* This is TRUE if anything has queued a redraw since we were last
@@ -857,6 +957,10 @@ struct _ClutterActorPrivate
   guint had_effects_on_last_paint_volume_update : 1;
   guint absolute_origin_changed     : 1;
   guint needs_update_stage_views    : 1;
+  guint in_animation_batch          : 1;
+  guint keep_size_requests          : 1;
+  guint allocation_request_valid    : 1;
+  guint queued_as_relayout_boundary : 1;
 };
 
 enum
@@ -1047,6 +1151,8 @@ static void clutter_actor_set_natural_height_set (ClutterActor *self,
 static void clutter_actor_update_map_state       (ClutterActor  *self,
                                                   MapStateChange change);
 static void clutter_actor_unrealize_not_hiding   (ClutterActor *self);
+static void clutter_actor_invalidate_allocation_request (ClutterActor *self);
+static gboolean _clutter_actor_has_active_paint_volume_override_effects (ClutterActor *self);
 
 static void _clutter_actor_get_relative_transformation_matrix (ClutterActor *self,
                                                                ClutterActor *ancestor,
@@ -1574,6 +1680,13 @@ clutter_actor_update_map_state (ClutterActor  *self,
 #endif
 }
 
+static inline void
+clutter_actor_invalidate_last_paint_volume (ClutterActor *self)
+{
+  self->priv->last_paint_volume_current = FALSE;
+  self->priv->last_paint_box_valid = FALSE;
+}
+
 static void
 queue_update_stage_views (ClutterActor *actor)
 {
@@ -1719,6 +1832,7 @@ clutter_actor_real_unmap (ClutterActor *self)
    */
   _clutter_paint_volume_init_static (&priv->last_paint_volume, NULL);
   priv->last_paint_volume_valid = TRUE;
+  clutter_actor_invalidate_last_paint_volume (self);
 
   /* notify on parent mapped after potentially unmapping
    * children, so apps see a bottom-up notification.
@@ -1936,6 +2050,7 @@ clutter_actor_real_hide (ClutterActor *self)
     return;
 
   CLUTTER_ACTOR_UNSET_FLAGS (self, CLUTTER_ACTOR_VISIBLE);
+  clutter_actor_invalidate_allocation_request (self);
 
   /* we notify on the "visible" flag in the clutter_actor_hide()
    * wrapper so the entire hide signal emission completes first,
@@ -2211,9 +2326,13 @@ unrealize_actor_after_children_cb (ClutterActor *self,
 
   if (stage != NULL &&
       self->priv->parent != NULL &&
-      self->priv->parent->flags & CLUTTER_ACTOR_NO_LAYOUT)
+      (self->priv->parent->flags & CLUTTER_ACTOR_NO_LAYOUT ||
+       self->priv->queued_as_relayout_boundary))
     clutter_stage_dequeue_actor_relayout (CLUTTER_STAGE (stage), self);
 
+  self->priv->queued_as_relayout_boundary = FALSE;
+  clutter_actor_invalidate_allocation_request (self);
+
   return CLUTTER_ACTOR_TRAVERSE_VISIT_CONTINUE;
 }
 
@@ -2536,6 +2655,7 @@ clutter_actor_notify_if_geometry_changed (ClutterActor          *self,
 static void
 absolute_geometry_changed (ClutterActor *actor)
 {
+  clutter_actor_invalidate_last_paint_volume (actor);
   queue_update_stage_views (actor);
 }
 
@@ -2781,6 +2901,143 @@ clutter_actor_needs_relayout (ClutterActor *self)
           priv->needs_allocation);
 }
 
+static inline gboolean
+clutter_actor_has_fixed_size (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  return (priv->min_width_set && priv->natural_width_set &&
+          priv->min_height_set && priv->natural_height_set);
+}
+
+static void
+clutter_actor_get_layout_state (ClutterActor *self,
+                                LayoutState  *state)
+{
+  ClutterActorPrivate *priv = self->priv;
+  const ClutterLayoutInfo *info;
+
+  info = _clutter_actor_get_layout_info_or_defaults (self);
+
+  memset (state, 0, sizeof (LayoutState));
+
+  state->min_width = info->minimum.width;
+  state->natural_width = info->natural.width;
+  state->min_height = info->minimum.height;
+  state->natural_height = info->natural.height;
+
+  state->fixed_pos = info->fixed_pos;
+  state->margin = info->margin;
+
+  state->x_align = info->x_align;
+  state->y_align = info->y_align;
+  state->x_expand = info->x_expand;
+  state->y_expand = info->y_expand;
+
+  if (CLUTTER_ACTOR_IS_VISIBLE (self))
+    state->flags |= LAYOUT_STATE_VISIBLE;
+  if (priv->position_set)
+    state->flags |= LAYOUT_STATE_POSITION_SET;
+  if (priv->x_expand_set)
+    state->flags |= LAYOUT_STATE_X_EXPAND_SET;
+  if (priv->y_expand_set)
+    state->flags |= LAYOUT_STATE_Y_EXPAND_SET;
+  if (priv->needs_x_expand)
+    state->flags |= LAYOUT_STATE_NEEDS_X_EXPAND;
+  if (priv->needs_y_expand)
+    state->flags |= LAYOUT_STATE_NEEDS_Y_EXPAND;
+  if (priv->needs_compute_expand)
+    state->flags |= LAYOUT_STATE_COMPUTE_EXPAND;
+}
+
+/*< private >
+ * clutter_actor_store_allocation_request:
+ * @self: a #ClutterActor
+ * @box: the box passed to clutter_actor_allocate()
+ *
+ * Remembers @box, and for actors with a fixed size, the state their
+ * parent based its layout on.
+ */
+static void
+clutter_actor_store_allocation_request (ClutterActor          *self,
+                                        const ClutterActorBox *box)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  priv->allocation_request = *box;
+  priv->allocation_request_valid = TRUE;
+
+  if (!clutter_actor_has_fixed_size (self))
+    {
+      g_clear_pointer (&priv->layout_state, g_free);
+      return;
+    }
+
+  if (priv->layout_state == NULL)
+    priv->layout_state = g_new (LayoutState, 1);
+
+  clutter_actor_get_layout_state (self, priv->layout_state);
+}
+
+static void
+clutter_actor_invalidate_allocation_request (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  priv->allocation_request_valid = FALSE;
+  g_clear_pointer (&priv->layout_state, g_free);
+}
+
+/*< private >
+ * clutter_actor_is_relayout_boundary:
+ * @self: a #ClutterActor
+ *
+ * Checks whether a relayout of @self can stop at @self instead of
+ * going up to its parent: this is the case when @self has a fixed
+ * size and nothing else the layout of the parent depends on changed
+ * since the parent last allocated it, so @self would be given the
+ * same box again.
+ *
+ * Return value: %TRUE if @self is a relayout boundary
+ */
+static gboolean
+clutter_actor_is_relayout_boundary (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  LayoutState state;
+
+  if (priv->layout_state == NULL || !priv->allocation_request_valid)
+    return FALSE;
+
+  if (!clutter_actor_has_fixed_size (self))
+    return FALSE;
+
+  clutter_actor_get_layout_state (self, &state);
+
+  return memcmp (&state, priv->layout_state, sizeof (LayoutState)) == 0;
+}
+
+static void
+clutter_actor_invalidate_size_request_cache (ClutterActor *self)
+{
+  SizeRequestCache *cache = self->priv->size_request_cache;
+
+  if (cache == NULL)
+    return;
+
+  cache->generation += 1;
+
+  /* An age of 0 means the entry is not set */
+  if (G_UNLIKELY (cache->generation == 0))
+    {
+      unsigned int size = get_size_request_cache_size ();
+
+      memset (cache->width_requests, 0, size * sizeof (SizeRequest));
+      memset (cache->height_requests, 0, size * sizeof (SizeRequest));
+      cache->generation = 1;
+    }
+}
+
 static void
 clutter_actor_real_queue_relayout (ClutterActor *self)
 {
@@ -2790,17 +3047,25 @@ clutter_actor_real_queue_relayout (ClutterActor *self)
   if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
     return;
 
-  priv->needs_width_request  = TRUE;
-  priv->needs_height_request = TRUE;
+  /* moving an actor doesn't change its own size requests, only those of
+   * its parent; see clutter_actor_queue_position_relayout()
+   */
+  if (!priv->keep_size_requests)
+    {
+      priv->needs_width_request  = TRUE;
+      priv->needs_height_request = TRUE;
+
+      /* reset the cached size requests */
+      memset (priv->width_requests, 0,
+              N_CACHED_SIZE_REQUESTS * sizeof (SizeRequest));
+      memset (priv->height_requests, 0,
+              N_CACHED_SIZE_REQUESTS * sizeof (SizeRequest));
+      clutter_actor_invalidate_size_request_cache (self);
+    }
+
   priv->needs_allocation     = TRUE;
   priv->needs_paint_volume_update = TRUE;
 
-  /* reset the cached size requests */
-  memset (priv->width_requests, 0,
-          N_CACHED_SIZE_REQUESTS * sizeof (SizeRequest));
-  memset (priv->height_requests, 0,
-          N_CACHED_SIZE_REQUESTS * sizeof (SizeRequest));
-
   /* We may need to go all the way up the hierarchy */
   if (priv->parent != NULL)
     {
@@ -2813,6 +3078,24 @@ clutter_actor_real_queue_relayout (ClutterActor *self)
            */
           priv->parent->priv->needs_paint_volume_update = TRUE;
         }
+      else if (clutter_actor_is_relayout_boundary (self))
+        {
+          ClutterActor *iter;
+
+          /* The parent would allocate us with the same box as last
+           * time, so only our own subtree needs to be laid out again;
+           * the paint volumes of our ancestors still include ours,
+           * though, and they won't get a relayout to update them
+           */
+          for (iter = priv->parent; iter != NULL; iter = iter->priv->parent)
+            iter->priv->needs_paint_volume_update = TRUE;
+
+          if (!priv->queued_as_relayout_boundary)
+            {
+              priv->queued_as_relayout_boundary = TRUE;
+              clutter_actor_queue_shallow_relayout (self);
+            }
+        }
       else
         {
           _clutter_actor_queue_only_relayout (priv->parent);
@@ -3393,11 +3676,36 @@ _clutter_actor_paint_cull_result (ClutterActor      *self,
     }
 }
 
+typedef struct _ClonePaint
+{
+  ClutterActor *source;
+
+  /* from the coordinates of the source to stage coordinates, as the
+   * source is painted by the clone
+   */
+  CoglMatrix transform;
+} ClonePaint;
+
+static GArray *clone_paints = NULL;
 static int clone_paint_level = 0;
 
+static gboolean clutter_actor_get_paint_transform (ClutterActor *self,
+                                                   CoglMatrix   *matrix);
+
 void
-_clutter_actor_push_clone_paint (void)
+_clutter_actor_push_clone_paint (ClutterActor *clone,
+                                 ClutterActor *source)
 {
+  ClonePaint clone_paint;
+
+  clone_paint.source = source;
+  if (!clutter_actor_get_paint_transform (clone, &clone_paint.transform))
+    clone_paint.source = NULL;
+
+  if (G_UNLIKELY (clone_paints == NULL))
+    clone_paints = g_array_new (FALSE, FALSE, sizeof (ClonePaint));
+
+  g_array_append_val (clone_paints, clone_paint);
   clone_paint_level++;
 }
 
@@ -3405,6 +3713,7 @@ void
 _clutter_actor_pop_clone_paint (void)
 {
   clone_paint_level--;
+  g_array_set_size (clone_paints, clone_paint_level);
 }
 
 static gboolean
@@ -3413,6 +3722,68 @@ in_clone_paint (void)
   return clone_paint_level > 0;
 }
 
+/*< private >
+ * clutter_actor_get_paint_transform:
+ * @self: a #ClutterActor
+ * @matrix: (out): return location for the transformation
+ *
+ * Retrieves the transformation from @self to stage coordinates as it
+ * is being painted; inside a clone paint this goes through the clone
+ * rather than through the ancestors of the clone source.
+ *
+ * Return value: %FALSE if the transformation is unknown
+ */
+static gboolean
+clutter_actor_get_paint_transform (ClutterActor *self,
+                                   CoglMatrix   *matrix)
+{
+  const ClonePaint *clone_paint;
+
+  if (!in_clone_paint ())
+    {
+      _clutter_actor_get_relative_transformation_matrix (self, NULL, matrix);
+      return TRUE;
+    }
+
+  clone_paint = &g_array_index (clone_paints, ClonePaint,
+                                clone_paint_level - 1);
+
+  if (clone_paint->source == NULL ||
+      !clutter_actor_contains (clone_paint->source, self))
+    return FALSE;
+
+  *matrix = clone_paint->transform;
+  _clutter_actor_apply_relative_transformation_matrix (self,
+                                                       clone_paint->source,
+                                                       matrix);
+
+  return TRUE;
+}
+
+/* Retrieves the paint volume of an actor painted as part of a clone, in
+ * stage coordinates
+ */
+static gboolean
+clutter_actor_get_clone_paint_volume (ClutterActor       *self,
+                                      ClutterPaintVolume *pv)
+{
+  const ClutterPaintVolume *volume;
+  CoglMatrix matrix;
+
+  if (!clutter_actor_get_paint_transform (self, &matrix))
+    return FALSE;
+
+  volume = clutter_actor_get_paint_volume (self);
+  if (volume == NULL)
+    return FALSE;
+
+  _clutter_paint_volume_copy_static (volume, pv);
+  _clutter_paint_volume_set_reference_actor (pv, NULL);
+  _clutter_paint_volume_transform (pv, &matrix);
+
+  return TRUE;
+}
+
 /* Returns TRUE if the actor can be ignored */
 /* FIXME: we should return a ClutterCullResult, and
  * clutter_actor_paint should understand that a CLUTTER_CULL_RESULT_IN
@@ -3426,8 +3797,10 @@ cull_actor (ClutterActor        *self,
   ClutterActorPrivate *priv = self->priv;
   ClutterStage *stage;
   const ClutterPlane *stage_clip;
+  ClutterPaintVolume clone_paint_volume;
+  ClutterPaintVolume *pv;
 
-  if (!priv->last_paint_volume_valid)
+  if (!in_clone_paint () && !priv->last_paint_volume_valid)
     {
       CLUTTER_NOTE (CLIPPING, "Bail from cull_actor without culling (%s): "
                     "->last_paint_volume_valid == FALSE",
@@ -3456,8 +3829,27 @@ cull_actor (ClutterActor        *self,
       return FALSE;
     }
 
-  *result_out =
-    _clutter_paint_volume_cull (&priv->last_paint_volume, stage_clip);
+  /* Inside a clone paint the actor is not where its last paint volume
+   * says, but where the clone puts it
+   */
+  if (in_clone_paint ())
+    {
+      if (!clutter_actor_get_clone_paint_volume (self, &clone_paint_volume))
+        {
+          CLUTTER_NOTE (CLIPPING, "Bail from cull_actor without culling (%s): "
+                        "No paint volume inside clone",
+                        _clutter_actor_get_debug_name (self));
+          return FALSE;
+        }
+
+      pv = &clone_paint_volume;
+    }
+  else
+    {
+      pv = &priv->last_paint_volume;
+    }
+
+  *result_out = _clutter_paint_volume_cull (pv, stage_clip);
 
   if (*result_out != CLUTTER_CULL_RESULT_OUT)
     {
@@ -3470,9 +3862,25 @@ cull_actor (ClutterActor        *self,
           cairo_rectangle_int_t paint_box_bounds;
           cairo_region_overlap_t overlap;
 
-          _clutter_paint_volume_get_stage_paint_box (&priv->last_paint_volume,
-                                                     stage,
-                                                     &paint_box);
+          /* The stage paint box doesn't depend on the view, so it is
+           * only computed once for all the views the actor is on
+           */
+          if (pv != &priv->last_paint_volume)
+            {
+              _clutter_paint_volume_get_stage_paint_box (pv, stage,
+                                                         &paint_box);
+            }
+          else
+            {
+              if (!priv->last_paint_box_valid)
+                {
+                  _clutter_paint_volume_get_stage_paint_box (pv, stage,
+                                                             &priv->last_paint_box);
+                  priv->last_paint_box_valid = priv->last_paint_volume_current;
+                }
+
+              paint_box = priv->last_paint_box;
+            }
 
           paint_box_bounds.x = floorf (paint_box.x1);
           paint_box_bounds.y = floorf (paint_box.y1);
@@ -3496,22 +3904,80 @@ cull_actor (ClutterActor        *self,
         }
     }
 
+  if (pv == &clone_paint_volume)
+    clutter_paint_volume_free (&clone_paint_volume);
+
   return TRUE;
 }
 
+/*< private >
+ * pick_cull_actor:
+ * @self: a #ClutterActor
+ *
+ * Checks whether @self, and therefore all its children, can be skipped
+ * when picking, because it is outside of the view being picked. This
+ * only uses the paint volume of the last paint, as picking must not
+ * update it, so it can only tell as long as neither the actor nor any
+ * of its children changed.
+ *
+ * Return value: %TRUE if the actor can be ignored
+ */
+static gboolean
+pick_cull_actor (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterStage *stage;
+  const ClutterPlane *stage_clip;
+
+  if (!priv->last_paint_volume_valid || !priv->last_paint_volume_current)
+    return FALSE;
+
+  /* Something in the subtree changed, so the last paint volume doesn't
+   * necessarily cover it anymore
+   */
+  if (priv->needs_paint_volume_update)
+    return FALSE;
+
+  if (priv->inhibit_culling_counter > 0 || in_clone_paint ())
+    return FALSE;
+
+  if (G_UNLIKELY (clutter_paint_debug_flags & CLUTTER_DEBUG_DISABLE_CULLING))
+    return FALSE;
+
+  stage = (ClutterStage *) _clutter_actor_get_stage_internal (self);
+  stage_clip = _clutter_stage_get_clip (stage);
+  if (G_UNLIKELY (!stage_clip))
+    return FALSE;
+
+  return _clutter_paint_volume_cull (&priv->last_paint_volume, stage_clip) ==
+         CLUTTER_CULL_RESULT_OUT;
+}
+
 static void
 _clutter_actor_update_last_paint_volume (ClutterActor *self)
 {
   ClutterActorPrivate *priv = self->priv;
   const ClutterPaintVolume *pv;
 
+  /* Fetching the paint volume invalidates the last paint volume if the
+   * paint volume had to be recomputed
+   */
+  pv = clutter_actor_get_paint_volume (self);
+
+  /* Nothing changed since the last time, e.g. when painting the
+   * previous view; the transformed paint volume is still good
+   */
+  if (pv && priv->last_paint_volume_valid && priv->last_paint_volume_current)
+    return;
+
   if (priv->last_paint_volume_valid)
     {
       clutter_paint_volume_free (&priv->last_paint_volume);
       priv->last_paint_volume_valid = FALSE;
     }
 
-  pv = clutter_actor_get_paint_volume (self);
+  clutter_actor_invalidate_last_paint_volume (self);
+
   if (!pv)
     {
       CLUTTER_NOTE (CLIPPING, "Bail from update_last_paint_volume (%s): "
@@ -3526,6 +3992,11 @@ _clutter_actor_update_last_paint_volume (ClutterActor *self)
                                             NULL); /* eye coordinates */
 
   priv->last_paint_volume_valid = TRUE;
+
+  /* Effects can change the paint volume on every paint */
+  priv->last_paint_volume_current =
+    priv->current_effect == NULL &&
+    !_clutter_actor_has_active_paint_volume_override_effects (self);
 }
 
 /* This is the same as clutter_actor_add_effect except that it doesn't
@@ -3885,17 +4356,14 @@ clutter_actor_paint (ClutterActor        *self,
    * We also fetch the current paint volume to perform culling so
    * we can avoid painting actors outside the current clip region.
    *
-   * If we are painting inside a clone, we should neither update
-   * the paint volume or use it to cull painting, since the paint
-   * box represents the location of the source actor on the
-   * screen.
-   *
-   * XXX: We are starting to do a lot of vertex transforms on
-   * the CPU in a typical paint, so at some point we should
-   * audit these and consider caching some things.
+   * The paint volume is kept in stage coordinates until the actor
+   * or one of its ancestors changes, so painting the same actor on
+   * several views only transforms it once.
    *
-   * NB: We don't perform culling while picking at this point because
-   * clutter-stage.c doesn't setup the clipping planes appropriately.
+   * If we are painting inside a clone, we should not update the
+   * paint volume, since the paint box represents the location of
+   * the source actor on the screen; cull_actor() transforms the
+   * paint volume through the clone instead.
    *
    * NB: We don't want to update the last-paint-volume during picking
    * because the last-paint-volume is used to determine the old screen
@@ -3906,14 +4374,15 @@ clutter_actor_paint (ClutterActor        *self,
    * actor position not the old.
    */
   culling_inhibited = priv->inhibit_culling_counter > 0;
-  if (!culling_inhibited && !in_clone_paint ())
+  if (!culling_inhibited)
     {
       gboolean success;
       /* annoyingly gcc warns if uninitialized even though
        * the initialization is redundant :-( */
       ClutterCullResult result = CLUTTER_CULL_RESULT_IN;
 
-      if (G_LIKELY ((clutter_paint_debug_flags &
+      if (!in_clone_paint () &&
+          G_LIKELY ((clutter_paint_debug_flags &
                      (CLUTTER_DEBUG_DISABLE_CULLING |
                       CLUTTER_DEBUG_DISABLE_CLIPPED_REDRAWS)) !=
                     (CLUTTER_DEBUG_DISABLE_CULLING |
@@ -4065,6 +4534,10 @@ clutter_actor_pick (ClutterActor       *actor,
   if (!CLUTTER_ACTOR_IS_MAPPED (actor))
     return;
 
+  /* nothing outside of the view can be picked in it */
+  if (pick_cull_actor (actor))
+    return;
+
   /* mark that we are in the paint process */
   CLUTTER_SET_PRIVATE_FLAGS (actor, CLUTTER_IN_PICK);
 
@@ -4246,6 +4719,8 @@ remove_child (ClutterActor *self,
   if (self->priv->last_child == child)
     self->priv->last_child = prev_sibling;
 
+  clutter_actor_invalidate_allocation_request (child);
+
   child->priv->parent = NULL;
   child->priv->prev_sibling = NULL;
   child->priv->next_sibling = NULL;
@@ -4507,6 +4982,38 @@ _clutter_actor_get_transform_info (ClutterActor *self)
   return info;
 }
 
+/* Queues a redraw for a change that only affects where the actor ends up
+ * on the stage, not what it draws. Offscreen effects render the actor
+ * without its own transformation, so their cached image stays valid.
+ */
+static void
+queue_redraw_for_transform (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterEffect *first_effect = NULL;
+
+  if (priv->effects != NULL)
+    {
+      const GList *l;
+
+      for (l = _clutter_meta_group_peek_metas (priv->effects);
+           l != NULL;
+           l = l->next)
+        {
+          if (clutter_actor_meta_get_enabled (l->data))
+            {
+              first_effect = l->data;
+              break;
+            }
+        }
+    }
+
+  _clutter_actor_queue_redraw_full (self,
+                                    0, /* flags */
+                                    NULL, /* clip */
+                                    first_effect);
+}
+
 static inline void
 clutter_actor_set_pivot_point_internal (ClutterActor           *self,
                                         const graphene_point_t *pivot)
@@ -4520,7 +5027,7 @@ clutter_actor_set_pivot_point_internal (ClutterActor           *self,
 
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_PIVOT_POINT]);
 
-  clutter_actor_queue_redraw (self);
+  queue_redraw_for_transform (self);
 }
 
 static inline void
@@ -4536,7 +5043,7 @@ clutter_actor_set_pivot_point_z_internal (ClutterActor *self,
 
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_PIVOT_POINT_Z]);
 
-  clutter_actor_queue_redraw (self);
+  queue_redraw_for_transform (self);
 }
 
 /*< private >
@@ -4568,7 +5075,7 @@ clutter_actor_set_translation_internal (ClutterActor *self,
 
   transform_changed (self);
 
-  clutter_actor_queue_redraw (self);
+  queue_redraw_for_transform (self);
   g_object_notify_by_pspec (obj, pspec);
 }
 
@@ -4701,7 +5208,7 @@ clutter_actor_set_rotation_angle_internal (ClutterActor *self,
 
   transform_changed (self);
 
-  clutter_actor_queue_redraw (self);
+  queue_redraw_for_transform (self);
 
   g_object_notify_by_pspec (G_OBJECT (self), pspec);
 }
@@ -4826,7 +5333,7 @@ clutter_actor_set_scale_factor_internal (ClutterActor *self,
 
   transform_changed (self);
 
-  clutter_actor_queue_redraw (self);
+  queue_redraw_for_transform (self);
   g_object_notify_by_pspec (obj, pspec);
 }
 
@@ -5721,6 +6228,15 @@ clutter_actor_finalize (GObject *object)
 
   g_free (priv->name);
 
+  if (priv->size_request_cache != NULL)
+    {
+      g_free (priv->size_request_cache->width_requests);
+      g_free (priv->size_request_cache->height_requests);
+      g_free (priv->size_request_cache);
+    }
+
+  g_free (priv->layout_state);
+
 #ifdef CLUTTER_ENABLE_DEBUG
   g_free (priv->debug_name);
 #endif
@@ -8073,6 +8589,7 @@ clutter_actor_init (ClutterActor *self)
   /* Initialize an empty paint volume to start with */
   _clutter_paint_volume_init_static (&priv->last_paint_volume, NULL);
   priv->last_paint_volume_valid = TRUE;
+  clutter_actor_invalidate_last_paint_volume (self);
 
   priv->transform_valid = FALSE;
 
@@ -8498,9 +9015,13 @@ _clutter_actor_queue_only_relayout (ClutterActor *self)
   if (CLUTTER_ACTOR_IN_DESTRUCTION (self))
     return;
 
+  /* an actor queued as a relayout boundary still has to tell its
+   * parent if anything the parent depends on changes afterwards
+   */
   if (priv->needs_width_request &&
       priv->needs_height_request &&
-      priv->needs_allocation)
+      priv->needs_allocation &&
+      !priv->queued_as_relayout_boundary)
     return; /* save some cpu cycles */
 
 #ifdef CLUTTER_ENABLE_DEBUG
@@ -8582,6 +9103,21 @@ clutter_actor_queue_relayout (ClutterActor *self)
   clutter_actor_queue_redraw (self);
 }
 
+/*
+ * Like clutter_actor_queue_relayout(), but for changes of the fixed position
+ * of @self, which affect the size requests of its ancestors and its own
+ * allocation, but not its own size requests.
+ */
+static void
+clutter_actor_queue_position_relayout (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  priv->keep_size_requests = TRUE;
+  clutter_actor_queue_relayout (self);
+  priv->keep_size_requests = FALSE;
+}
+
 /**
  * clutter_actor_get_preferred_size:
  * @self: a #ClutterActor
@@ -8877,15 +9413,71 @@ clutter_actor_adjust_height (ClutterActor *self,
 
 }
 
+static SizeRequest *
+get_hashed_size_request (SizeRequestCache   *cache,
+                         ClutterOrientation  orientation,
+                         float               for_size)
+{
+  SizeRequest *requests;
+  guint32 bits;
+
+  if (orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+    requests = cache->width_requests;
+  else
+    requests = cache->height_requests;
+
+  /* sizes are mostly whole numbers, which leave the low bits of the float
+   * representation empty; mix them well before masking
+   */
+  memcpy (&bits, &for_size, sizeof (bits));
+  bits ^= bits >> 16;
+  bits *= 0x85ebca6b;
+  bits ^= bits >> 13;
+  bits *= 0xc2b2ae35;
+  bits ^= bits >> 16;
+
+  return &requests[bits & (get_size_request_cache_size () - 1)];
+}
+
+static SizeRequestCache *
+ensure_size_request_cache (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  unsigned int size;
+
+  if (priv->size_request_cache != NULL)
+    return priv->size_request_cache;
+
+  size = get_size_request_cache_size ();
+  if (size == 0)
+    return NULL;
+
+  priv->size_request_cache = g_new0 (SizeRequestCache, 1);
+  priv->size_request_cache->generation = 1;
+  priv->size_request_cache->width_requests = g_new0 (SizeRequest, size);
+  priv->size_request_cache->height_requests = g_new0 (SizeRequest, size);
+
+  return priv->size_request_cache;
+}
+
 /* looks for a cached size request for this for_size. If not
  * found, returns the oldest entry so it can be overwritten */
 static gboolean
-_clutter_actor_get_cached_size_request (gfloat         for_size,
-                                        SizeRequest   *cached_size_requests,
-                                        SizeRequest  **result)
+_clutter_actor_get_cached_size_request (ClutterActor        *self,
+                                        ClutterOrientation   orientation,
+                                        gfloat               for_size,
+                                        SizeRequest        **result)
 {
+  ClutterActorPrivate *priv = self->priv;
+  SizeRequest *cached_size_requests;
+  SizeRequestCache *cache;
   guint i;
 
+  if (orientation == CLUTTER_ORIENTATION_HORIZONTAL)
+    cached_size_requests = priv->width_requests;
+  else
+    cached_size_requests = priv->height_requests;
+
   *result = &cached_size_requests[0];
 
   for (i = 0; i < N_CACHED_SIZE_REQUESTS; i++)
@@ -8898,6 +9490,7 @@ _clutter_actor_get_cached_size_request (gfloat         for_size,
           sr->for_size == for_size)
         {
           CLUTTER_NOTE (LAYOUT, "Size cache hit for size: %.2f", for_size);
+          size_request_cache_hits++;
           *result = sr;
           return TRUE;
         }
@@ -8907,11 +9500,64 @@ _clutter_actor_get_cached_size_request (gfloat         for_size,
         }
     }
 
+  cache = priv->size_request_cache;
+  if (cache != NULL)
+    {
+      SizeRequest *sr = get_hashed_size_request (cache, orientation, for_size);
+
+      if (sr->age == cache->generation &&
+          sr->for_size == for_size)
+        {
+          CLUTTER_NOTE (LAYOUT, "Hashed size cache hit for size: %.2f",
+                        for_size);
+          size_request_cache_hits++;
+          *result = sr;
+          return TRUE;
+        }
+    }
+
   CLUTTER_NOTE (LAYOUT, "Size cache miss for size: %.2f", for_size);
+  size_request_cache_misses++;
+
+  /* the oldest entry is about to be overwritten; keep it in the hashed
+   * cache in case it's asked for again before the next invalidation
+   */
+  if ((*result)->age > 0)
+    {
+      cache = ensure_size_request_cache (self);
+      if (cache != NULL)
+        {
+          SizeRequest *sr = get_hashed_size_request (cache, orientation,
+                                                     (*result)->for_size);
+
+          *sr = **result;
+          sr->age = cache->generation;
+        }
+    }
 
   return FALSE;
 }
 
+/*< private >
+ * _clutter_actor_get_size_request_cache_stats:
+ * @hits: (out): return location for the number of cache hits
+ * @misses: (out): return location for the number of cache misses
+ *
+ * Retrieves and resets the number of preferred size requests of all
+ * actors that were answered from the size request caches, and of those
+ * that had to be computed.
+ */
+void
+_clutter_actor_get_size_request_cache_stats (unsigned int *hits,
+                                             unsigned int *misses)
+{
+  *hits = size_request_cache_hits;
+  *misses = size_request_cache_misses;
+
+  size_request_cache_hits = 0;
+  size_request_cache_misses = 0;
+}
+
 static void
 clutter_actor_update_preferred_size_for_constraints (ClutterActor *self,
                                                      ClutterOrientation direction,
@@ -9036,8 +9682,9 @@ clutter_actor_get_preferred_width (ClutterActor *self,
   if (!priv->needs_width_request)
     {
       found_in_cache =
-        _clutter_actor_get_cached_size_request (for_height,
-                                                priv->width_requests,
+        _clutter_actor_get_cached_size_request (self,
+                                                CLUTTER_ORIENTATION_HORIZONTAL,
+                                                for_height,
                                                 &cached_size_request);
     }
   else
@@ -9054,6 +9701,9 @@ clutter_actor_get_preferred_width (ClutterActor *self,
 
       minimum_width = natural_width = 0;
 
+      /* the cache is looked up with the requested size */
+      cached_size_request->for_size = for_height;
+
       /* adjust for the margin */
       if (for_height >= 0)
         {
@@ -9088,7 +9738,6 @@ clutter_actor_get_preferred_width (ClutterActor *self,
 
       cached_size_request->min_size = minimum_width;
       cached_size_request->natural_size = natural_width;
-      cached_size_request->for_size = for_height;
       cached_size_request->age = priv->cached_width_age;
 
       priv->cached_width_age += 1;
@@ -9201,8 +9850,9 @@ clutter_actor_get_preferred_height (ClutterActor *self,
   if (!priv->needs_height_request)
     {
       found_in_cache =
-        _clutter_actor_get_cached_size_request (for_width,
-                                                priv->height_requests,
+        _clutter_actor_get_cached_size_request (self,
+                                                CLUTTER_ORIENTATION_VERTICAL,
+                                                for_width,
                                                 &cached_size_request);
     }
   else
@@ -9220,6 +9870,9 @@ clutter_actor_get_preferred_height (ClutterActor *self,
 
       CLUTTER_NOTE (LAYOUT, "Height request for %.2f px", for_width);
 
+      /* the cache is looked up with the requested size */
+      cached_size_request->for_size = for_width;
+
       /* adjust for margin */
       if (for_width >= 0)
         {
@@ -9252,7 +9905,6 @@ clutter_actor_get_preferred_height (ClutterActor *self,
 
       cached_size_request->min_size = minimum_height;
       cached_size_request->natural_size = natural_height;
-      cached_size_request->for_size = for_width;
       cached_size_request->age = priv->cached_height_age;
 
       priv->cached_height_age += 1;
@@ -9574,9 +10226,35 @@ clutter_actor_allocate (ClutterActor          *self,
                                    NULL);
         }
 
+      clutter_actor_invalidate_allocation_request (self);
       goto out;
     }
 
+  /* If we are given the same box as last time and nothing changed
+   * since, the outcome will be the same as well; skip straight to
+   * notifying the sub-tree, without going through the constraints
+   * and the alignment again.
+   */
+  if (!priv->needs_allocation &&
+      priv->allocation_request_valid &&
+      priv->constraints == NULL &&
+      clutter_actor_box_equal (box, &priv->allocation_request))
+    {
+      if (priv->absolute_origin_changed)
+        {
+          _clutter_actor_traverse (self,
+                                   CLUTTER_ACTOR_TRAVERSE_DEPTH_FIRST,
+                                   absolute_geometry_changed_cb,
+                                   NULL,
+                                   NULL);
+        }
+
+      CLUTTER_NOTE (LAYOUT, "Same allocation request, no allocation needed");
+      goto out;
+    }
+
+  clutter_actor_store_allocation_request (self, box);
+
   old_allocation = priv->allocation;
   real_allocation = *box;
 
@@ -9656,6 +10334,40 @@ out:
   priv->absolute_origin_changed = FALSE;
 }
 
+/*< private >
+ * _clutter_actor_allocate_relayout_boundary:
+ * @self: a #ClutterActor
+ *
+ * Lays out @self again with the box its parent last allocated it with,
+ * if a relayout of @self was queued without involving its parent; see
+ * clutter_actor_is_relayout_boundary().
+ *
+ * Return value: %TRUE if @self was queued as a relayout boundary
+ */
+gboolean
+_clutter_actor_allocate_relayout_boundary (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+  ClutterActorBox box;
+
+  if (!priv->queued_as_relayout_boundary)
+    return FALSE;
+
+  priv->queued_as_relayout_boundary = FALSE;
+
+  /* The actor was hidden or reparented since, and the parent was
+   * queued for relayout instead
+   */
+  if (!priv->allocation_request_valid ||
+      _clutter_actor_get_stage_internal (self) == NULL)
+    return TRUE;
+
+  box = priv->allocation_request;
+  clutter_actor_allocate (self, &box);
+
+  return TRUE;
+}
+
 /**
  * clutter_actor_set_allocation:
  * @self: a #ClutterActor
@@ -9787,7 +10499,7 @@ clutter_actor_set_fixed_position_set (ClutterActor *self,
   self->priv->position_set = is_set != FALSE;
   g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_FIXED_POSITION_SET]);
 
-  clutter_actor_queue_relayout (self);
+  clutter_actor_queue_position_relayout (self);
 }
 
 /**
@@ -10721,7 +11433,7 @@ clutter_actor_set_x_internal (ClutterActor *self,
 
   clutter_actor_notify_if_geometry_changed (self, &old);
 
-  clutter_actor_queue_relayout (self);
+  clutter_actor_queue_position_relayout (self);
 }
 
 static inline void
@@ -10744,7 +11456,7 @@ clutter_actor_set_y_internal (ClutterActor *self,
 
   clutter_actor_notify_if_geometry_changed (self, &old);
 
-  clutter_actor_queue_relayout (self);
+  clutter_actor_queue_position_relayout (self);
 }
 
 static void
@@ -10773,7 +11485,7 @@ clutter_actor_set_position_internal (ClutterActor           *self,
 
   clutter_actor_notify_if_geometry_changed (self, &old);
 
-  clutter_actor_queue_relayout (self);
+  clutter_actor_queue_position_relayout (self);
 }
 
 /**
@@ -11320,7 +12032,7 @@ clutter_actor_set_z_position_internal (ClutterActor *self,
 
       transform_changed (self);
 
-      clutter_actor_queue_redraw (self);
+      queue_redraw_for_transform (self);
 
       g_object_notify_by_pspec (G_OBJECT (self), obj_props[PROP_Z_POSITION]);
     }
@@ -13524,6 +14236,64 @@ clutter_actor_get_initial_state (ClutterAnimatable *animatable,
   g_free (p_name);
 }
 
+/* Actors animated while advancing the timelines for a frame; their
+ * property notifications are held back until all timelines have been
+ * advanced, so that animating several properties of an actor emits its
+ * notifications in one go.
+ */
+static GPtrArray *animation_batch_actors = NULL;
+static int animation_batch_depth = 0;
+
+static void
+maybe_add_to_animation_batch (ClutterActor *self)
+{
+  ClutterActorPrivate *priv = self->priv;
+
+  if (animation_batch_depth == 0 || priv->in_animation_batch)
+    return;
+
+  if (animation_batch_actors == NULL)
+    animation_batch_actors = g_ptr_array_new ();
+
+  priv->in_animation_batch = TRUE;
+  g_object_freeze_notify (G_OBJECT (self));
+  g_ptr_array_add (animation_batch_actors, g_object_ref (self));
+}
+
+void
+_clutter_actor_begin_animation_batch (void)
+{
+  animation_batch_depth++;
+}
+
+void
+_clutter_actor_end_animation_batch (void)
+{
+  unsigned int i;
+
+  g_return_if_fail (animation_batch_depth > 0);
+
+  if (--animation_batch_depth > 0)
+    return;
+
+  if (animation_batch_actors == NULL || animation_batch_actors->len == 0)
+    return;
+
+  /* Notification handlers may animate actors again; those are not batched
+   * anymore, so the array doesn't change while iterating it.
+   */
+  for (i = 0; i < animation_batch_actors->len; i++)
+    {
+      ClutterActor *actor = g_ptr_array_index (animation_batch_actors, i);
+
+      actor->priv->in_animation_batch = FALSE;
+      g_object_thaw_notify (G_OBJECT (actor));
+      g_object_unref (actor);
+    }
+
+  g_ptr_array_set_size (animation_batch_actors, 0);
+}
+
 /*
  * clutter_actor_set_animatable_property:
  * @actor: a #ClutterActor
@@ -13551,6 +14321,8 @@ clutter_actor_set_animatable_property (ClutterActor *actor,
 {
   GObject *obj = G_OBJECT (actor);
 
+  maybe_add_to_animation_batch (actor);
+
   g_object_freeze_notify (obj);
 
   switch (prop_id)
@@ -13656,6 +14428,195 @@ clutter_actor_set_animatable_property (ClutterActor *actor,
   g_object_thaw_notify (obj);
 }
 
+static void clutter_actor_set_final_state (ClutterAnimatable *animatable,
+                                           const gchar       *property_name,
+                                           const GValue      *final);
+
+/*< private >
+ * _clutter_actor_interpolate_animatable_property:
+ * @self: a #ClutterActor
+ * @pspec: the #GParamSpec of the animated property
+ * @interval: the #ClutterInterval of the transition
+ * @progress: the progress of the transition
+ *
+ * Interpolates one of the animatable properties of #ClutterActor itself
+ * and stores the result directly in the actor, without going through
+ * #GValue and the #ClutterAnimatable interface.
+ *
+ * Return value: %TRUE if the property was updated, and %FALSE if the
+ *   caller has to use clutter_animatable_interpolate_value() and
+ *   clutter_animatable_set_final_state() instead
+ */
+gboolean
+_clutter_actor_interpolate_animatable_property (ClutterActor    *self,
+                                                GParamSpec      *pspec,
+                                                ClutterInterval *interval,
+                                                double           progress)
+{
+  ClutterAnimatableInterface *iface;
+  gboolean res = FALSE;
+
+  if (pspec->owner_type != CLUTTER_TYPE_ACTOR ||
+      (pspec->flags & CLUTTER_PARAM_ANIMATABLE) == 0)
+    return FALSE;
+
+  /* Sub-classes may implement the interface again */
+  iface = CLUTTER_ANIMATABLE_GET_IFACE (self);
+  if (iface->interpolate_value != NULL ||
+      iface->set_final_state != clutter_actor_set_final_state)
+    return FALSE;
+
+  maybe_add_to_animation_batch (self);
+
+  g_object_freeze_notify (G_OBJECT (self));
+
+  switch (pspec->param_id)
+    {
+    case PROP_X:
+    case PROP_Y:
+    case PROP_WIDTH:
+    case PROP_HEIGHT:
+    case PROP_Z_POSITION:
+    case PROP_PIVOT_POINT_Z:
+    case PROP_TRANSLATION_X:
+    case PROP_TRANSLATION_Y:
+    case PROP_TRANSLATION_Z:
+    case PROP_MARGIN_TOP:
+    case PROP_MARGIN_BOTTOM:
+    case PROP_MARGIN_LEFT:
+    case PROP_MARGIN_RIGHT:
+      {
+        float value;
+
+        res = clutter_interval_compute_float (interval, progress, &value);
+        if (!res)
+          break;
+
+        switch (pspec->param_id)
+          {
+          case PROP_X:
+            clutter_actor_set_x_internal (self, value);
+            break;
+          case PROP_Y:
+            clutter_actor_set_y_internal (self, value);
+            break;
+          case PROP_WIDTH:
+            clutter_actor_set_width_internal (self, value);
+            break;
+          case PROP_HEIGHT:
+            clutter_actor_set_height_internal (self, value);
+            break;
+          case PROP_Z_POSITION:
+            clutter_actor_set_z_position_internal (self, value);
+            break;
+          case PROP_PIVOT_POINT_Z:
+            clutter_actor_set_pivot_point_z_internal (self, value);
+            break;
+          case PROP_TRANSLATION_X:
+          case PROP_TRANSLATION_Y:
+          case PROP_TRANSLATION_Z:
+            clutter_actor_set_translation_internal (self, value, pspec);
+            break;
+          default:
+            clutter_actor_set_margin_internal (self, value, pspec);
+            break;
+          }
+      }
+      break;
+
+    case PROP_SCALE_X:
+    case PROP_SCALE_Y:
+    case PROP_SCALE_Z:
+    case PROP_ROTATION_ANGLE_X:
+    case PROP_ROTATION_ANGLE_Y:
+    case PROP_ROTATION_ANGLE_Z:
+      {
+        double value;
+
+        res = clutter_interval_compute_double (interval, progress, &value);
+        if (!res)
+          break;
+
+        if (pspec->param_id == PROP_SCALE_X ||
+            pspec->param_id == PROP_SCALE_Y ||
+            pspec->param_id == PROP_SCALE_Z)
+          clutter_actor_set_scale_factor_internal (self, value, pspec);
+        else
+          clutter_actor_set_rotation_angle_internal (self, value, pspec);
+      }
+      break;
+
+    case PROP_OPACITY:
+      {
+        unsigned int value;
+
+        res = clutter_interval_compute_uint (interval, progress, &value);
+        if (res)
+          clutter_actor_set_opacity_internal (self, value);
+      }
+      break;
+
+    case PROP_BACKGROUND_COLOR:
+      {
+        ClutterColor value;
+
+        res = clutter_interval_compute_color (interval, progress, &value);
+        if (res)
+          clutter_actor_set_background_color_internal (self, &value);
+      }
+      break;
+
+    case PROP_POSITION:
+    case PROP_PIVOT_POINT:
+      {
+        graphene_point_t value;
+
+        res = clutter_interval_compute_point (interval, progress, &value);
+        if (!res)
+          break;
+
+        if (pspec->param_id == PROP_POSITION)
+          clutter_actor_set_position_internal (self, &value);
+        else
+          clutter_actor_set_pivot_point_internal (self, &value);
+      }
+      break;
+
+    case PROP_SIZE:
+      {
+        graphene_size_t value;
+
+        res = clutter_interval_compute_size (interval, progress, &value);
+        if (res)
+          clutter_actor_set_size_internal (self, &value);
+      }
+      break;
+
+    case PROP_TRANSFORM:
+    case PROP_CHILD_TRANSFORM:
+      {
+        ClutterMatrix value;
+
+        res = clutter_interval_compute_matrix (interval, progress, &value);
+        if (!res)
+          break;
+
+        if (pspec->param_id == PROP_TRANSFORM)
+          clutter_actor_set_transform_internal (self, &value);
+        else
+          clutter_actor_set_child_transform_internal (self, &value);
+      }
+      break;
+
+    default:
+      break;
+    }
+
+  g_object_thaw_notify (G_OBJECT (self));
+
+  return res;
+}
+
 static void
 clutter_actor_set_final_state (ClutterAnimatable *animatable,
                                const gchar       *property_name,
@@ -14790,7 +15751,7 @@ clutter_actor_set_transform_internal (ClutterActor        *self,
 
   transform_changed (self);
 
-  clutter_actor_queue_redraw (self);
+  queue_redraw_for_transform (self);
 
   g_object_notify_by_pspec (obj, obj_props[PROP_TRANSFORM]);
 
@@ -15938,6 +16899,8 @@ _clutter_actor_get_paint_volume_mutable (ClutterActor *self)
       clutter_paint_volume_free (&priv->paint_volume);
     }
 
+  clutter_actor_invalidate_last_paint_volume (self);
+
   priv->had_effects_on_last_paint_volume_update = has_paint_volume_override_effects;
 
   if (_clutter_actor_get_paint_volume_real (self, &priv->paint_volume))
@@ -89,10 +89,15 @@ static void
 clutter_backend_dispose (GObject *gobject)
 {
   ClutterBackend *backend = CLUTTER_BACKEND (gobject);
+  ClutterMainContext *context = _clutter_context_get_default ();
 
   /* clear the events still in the queue of the main context */
   _clutter_clear_events_queue ();
 
+  /* The pooled render targets were created with our Cogl context */
+  if (context->backend == backend)
+    g_clear_pointer (&context->offscreen_pool, clutter_offscreen_pool_free);
+
   g_clear_pointer (&backend->dummy_onscreen, cogl_object_unref);
   if (backend->stage_window)
     {
@@ -118,14 +118,12 @@ clutter_matrix_copy (gpointer data)
   return cogl_matrix_copy (data);
 }
 
-static gboolean
-clutter_matrix_progress (const GValue *a,
-                         const GValue *b,
-                         gdouble       progress,
-                         GValue       *retval)
+void
+_clutter_matrix_interpolate (const ClutterMatrix *matrix1,
+                             const ClutterMatrix *matrix2,
+                             double               progress,
+                             ClutterMatrix       *res)
 {
-  const ClutterMatrix *matrix1 = g_value_get_boxed (a);
-  const ClutterMatrix *matrix2 = g_value_get_boxed (b);
   graphene_point3d_t scale1 = GRAPHENE_POINT3D_INIT (1.f, 1.f, 1.f);
   float shear1[3] = { 0.f, 0.f, 0.f };
   graphene_point3d_t rotate1 = GRAPHENE_POINT3D_INIT_ZERO;
@@ -141,9 +139,8 @@ clutter_matrix_progress (const GValue *a,
   graphene_point3d_t rotate_res = GRAPHENE_POINT3D_INIT_ZERO;
   graphene_point3d_t translate_res = GRAPHENE_POINT3D_INIT_ZERO;
   ClutterVertex4 perspective_res = { 0.f, 0.f, 0.f, 0.f };
-  ClutterMatrix res;
 
-  clutter_matrix_init_identity (&res);
+  clutter_matrix_init_identity (res);
 
   _clutter_util_matrix_decompose (matrix1,
                                   &scale1, shear1, &rotate1, &translate1,
@@ -154,37 +151,50 @@ clutter_matrix_progress (const GValue *a,
 
   /* perspective */
   _clutter_util_vertex4_interpolate (&perspective1, &perspective2, progress, &perspective_res);
-  res.wx = perspective_res.x;
-  res.wy = perspective_res.y;
-  res.wz = perspective_res.z;
-  res.ww = perspective_res.w;
+  res->wx = perspective_res.x;
+  res->wy = perspective_res.y;
+  res->wz = perspective_res.z;
+  res->ww = perspective_res.w;
 
   /* translation */
   graphene_point3d_interpolate (&translate1, &translate2, progress, &translate_res);
-  cogl_matrix_translate (&res, translate_res.x, translate_res.y, translate_res.z);
+  cogl_matrix_translate (res, translate_res.x, translate_res.y, translate_res.z);
 
   /* rotation */
   graphene_point3d_interpolate (&rotate1, &rotate2, progress, &rotate_res);
-  cogl_matrix_rotate (&res, rotate_res.x, 1.0f, 0.0f, 0.0f);
-  cogl_matrix_rotate (&res, rotate_res.y, 0.0f, 1.0f, 0.0f);
-  cogl_matrix_rotate (&res, rotate_res.z, 0.0f, 0.0f, 1.0f);
+  cogl_matrix_rotate (res, rotate_res.x, 1.0f, 0.0f, 0.0f);
+  cogl_matrix_rotate (res, rotate_res.y, 0.0f, 1.0f, 0.0f);
+  cogl_matrix_rotate (res, rotate_res.z, 0.0f, 0.0f, 1.0f);
 
   /* skew */
   shear_res = shear1[2] + (shear2[2] - shear1[2]) * progress; /* YZ */
   if (shear_res != 0.f)
-    _clutter_util_matrix_skew_yz (&res, shear_res);
+    _clutter_util_matrix_skew_yz (res, shear_res);
 
   shear_res = shear1[1] + (shear2[1] - shear1[1]) * progress; /* XZ */
   if (shear_res != 0.f)
-    _clutter_util_matrix_skew_xz (&res, shear_res);
+    _clutter_util_matrix_skew_xz (res, shear_res);
 
   shear_res = shear1[0] + (shear2[0] - shear1[0]) * progress; /* XY */
   if (shear_res != 0.f)
-    _clutter_util_matrix_skew_xy (&res, shear_res);
+    _clutter_util_matrix_skew_xy (res, shear_res);
 
   /* scale */
   graphene_point3d_interpolate (&scale1, &scale2, progress, &scale_res);
-  cogl_matrix_scale (&res, scale_res.x, scale_res.y, scale_res.z);
+  cogl_matrix_scale (res, scale_res.x, scale_res.y, scale_res.z);
+}
+
+static gboolean
+clutter_matrix_progress (const GValue *a,
+                         const GValue *b,
+                         gdouble       progress,
+                         GValue       *retval)
+{
+  const ClutterMatrix *matrix1 = g_value_get_boxed (a);
+  const ClutterMatrix *matrix2 = g_value_get_boxed (b);
+  ClutterMatrix res;
+
+  _clutter_matrix_interpolate (matrix1, matrix2, progress, &res);
 
   g_value_set_boxed (retval, &res);
 
@@ -30,6 +30,12 @@
  * #ClutterBlurEffect is a sub-class of #ClutterEffect that allows blurring a
  * actor and its contents.
  *
+ * By default a fixed 3x3 box blur is applied. Setting the
+ * #ClutterBlurEffect:radius property to a positive value switches to a
+ * downsampling dual Kawase blur, which is able to produce strong blurs
+ * while sampling only a fraction of the pixels of the actor. The result
+ * is kept around until the actor is redrawn or resized.
+ *
  * #ClutterBlurEffect is available since Clutter 1.4
  */
 
@@ -39,6 +45,8 @@
 
 #include "clutter-build-config.h"
 
+#include <math.h>
+
 #define CLUTTER_ENABLE_EXPERIMENTAL_API
 
 #include "clutter-blur-effect.h"
@@ -72,6 +80,50 @@ static const gchar *box_blur_glsl_shader =
 "  cogl_texel /= 9.0;\n";
 #undef SAMPLE
 
+/* Maximum number of downsampling steps used by the dual Kawase blur */
+#define MAX_BLUR_LEVELS 5
+
+static const gchar *kawase_blur_glsl_declarations =
+"uniform vec2 half_pixel;\n"
+"uniform float offset;\n";
+
+static const gchar *kawase_downsample_glsl_shader =
+"  vec2 uv = cogl_tex_coord.st;\n"
+"  vec2 o = half_pixel * offset;\n"
+"  cogl_texel = texture2D (cogl_sampler, uv) * 4.0;\n"
+"  cogl_texel += texture2D (cogl_sampler, uv - o);\n"
+"  cogl_texel += texture2D (cogl_sampler, uv + o);\n"
+"  cogl_texel += texture2D (cogl_sampler, uv + vec2 (o.x, -o.y));\n"
+"  cogl_texel += texture2D (cogl_sampler, uv - vec2 (o.x, -o.y));\n"
+"  cogl_texel /= 8.0;\n";
+
+static const gchar *kawase_upsample_glsl_shader =
+"  vec2 uv = cogl_tex_coord.st;\n"
+"  vec2 o = half_pixel * offset;\n"
+"  cogl_texel = texture2D (cogl_sampler, uv + vec2 (-o.x * 2.0, 0.0));\n"
+"  cogl_texel += texture2D (cogl_sampler, uv + vec2 (-o.x, o.y)) * 2.0;\n"
+"  cogl_texel += texture2D (cogl_sampler, uv + vec2 (0.0, o.y * 2.0));\n"
+"  cogl_texel += texture2D (cogl_sampler, uv + vec2 (o.x, o.y)) * 2.0;\n"
+"  cogl_texel += texture2D (cogl_sampler, uv + vec2 (o.x * 2.0, 0.0));\n"
+"  cogl_texel += texture2D (cogl_sampler, uv + vec2 (o.x, -o.y)) * 2.0;\n"
+"  cogl_texel += texture2D (cogl_sampler, uv + vec2 (0.0, -o.y * 2.0));\n"
+"  cogl_texel += texture2D (cogl_sampler, uv + vec2 (-o.x, -o.y)) * 2.0;\n"
+"  cogl_texel /= 12.0;\n";
+
+/*
+ * One level of the dual Kawase blur chain; level n is the offscreen
+ * texture downsampled n times. The down pipeline renders level n - 1 into
+ * this level, and the up pipeline renders this level into level n - 1, or
+ * into the paint target for the first level.
+ */
+typedef struct _BlurLevel
+{
+  CoglTexture *texture;
+  CoglFramebuffer *framebuffer;
+  CoglPipeline *down_pipeline;
+  CoglPipeline *up_pipeline;
+} BlurLevel;
+
 struct _ClutterBlurEffect
 {
   ClutterOffscreenEffect parent_instance;
@@ -85,6 +137,21 @@ struct _ClutterBlurEffect
   gint tex_height;
 
   CoglPipeline *pipeline;
+
+  float radius;
+
+  /* The intermediate textures are kept across frames, and only
+   * reallocated when the size of the offscreen texture changes.
+   */
+  BlurLevel levels[MAX_BLUR_LEVELS];
+  int n_levels;
+  int levels_width;
+  int levels_height;
+
+  /* Whether the levels need to be rendered again from the offscreen
+   * texture before the next paint.
+   */
+  gboolean blur_dirty;
 };
 
 struct _ClutterBlurEffectClass
@@ -92,12 +159,208 @@ struct _ClutterBlurEffectClass
   ClutterOffscreenEffectClass parent_class;
 
   CoglPipeline *base_pipeline;
+  CoglPipeline *base_down_pipeline;
+  CoglPipeline *base_up_pipeline;
 };
 
+enum
+{
+  PROP_0,
+
+  PROP_RADIUS,
+
+  PROP_LAST
+};
+
+static GParamSpec *obj_props[PROP_LAST];
+
 G_DEFINE_TYPE (ClutterBlurEffect,
                clutter_blur_effect,
                CLUTTER_TYPE_OFFSCREEN_EFFECT);
 
+static void
+clear_blur_levels (ClutterBlurEffect *self)
+{
+  int i;
+
+  for (i = 0; i < self->n_levels; i++)
+    {
+      BlurLevel *level = &self->levels[i];
+
+      cogl_clear_object (&level->down_pipeline);
+      cogl_clear_object (&level->up_pipeline);
+      cogl_clear_object (&level->framebuffer);
+      cogl_clear_object (&level->texture);
+    }
+
+  self->n_levels = 0;
+  self->levels_width = 0;
+  self->levels_height = 0;
+}
+
+static void
+calculate_blur_levels (float  radius,
+                       int   *n_levels,
+                       float *offset)
+{
+  int n;
+
+  /* Every level roughly doubles the extent of the blur, the sample offset
+   * then covers whatever remains of the radius.
+   */
+  n = 1;
+  while (n < MAX_BLUR_LEVELS && (1 << (n + 1)) < radius)
+    n++;
+
+  *n_levels = n;
+  *offset = radius / (1 << (n + 1));
+}
+
+static void
+setup_level_pipeline (CoglPipeline *pipeline,
+                      CoglTexture  *source,
+                      float         offset)
+{
+  int half_pixel_location;
+  int offset_location;
+  float half_pixel[2];
+
+  cogl_pipeline_set_layer_texture (pipeline, 0, source);
+
+  half_pixel[0] = 0.5f / cogl_texture_get_width (source);
+  half_pixel[1] = 0.5f / cogl_texture_get_height (source);
+
+  half_pixel_location = cogl_pipeline_get_uniform_location (pipeline,
+                                                            "half_pixel");
+  cogl_pipeline_set_uniform_float (pipeline,
+                                   half_pixel_location,
+                                   2, /* n_components */
+                                   1, /* count */
+                                   half_pixel);
+
+  offset_location = cogl_pipeline_get_uniform_location (pipeline, "offset");
+  cogl_pipeline_set_uniform_1f (pipeline, offset_location, offset);
+}
+
+static gboolean
+ensure_blur_levels (ClutterBlurEffect *self,
+                    CoglTexture       *source)
+{
+  ClutterBlurEffectClass *klass = CLUTTER_BLUR_EFFECT_GET_CLASS (self);
+  CoglContext *ctx =
+    clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  int n_levels;
+  float offset;
+  int i;
+
+  calculate_blur_levels (self->radius, &n_levels, &offset);
+
+  if (self->n_levels != n_levels ||
+      self->levels_width != self->tex_width ||
+      self->levels_height != self->tex_height)
+    {
+      clear_blur_levels (self);
+
+      for (i = 0; i < n_levels; i++)
+        {
+          BlurLevel *level = &self->levels[i];
+          g_autoptr (GError) error = NULL;
+          int width, height;
+
+          width = MAX (self->tex_width >> (i + 1), 1);
+          height = MAX (self->tex_height >> (i + 1), 1);
+
+          self->n_levels = i + 1;
+
+          level->texture =
+            COGL_TEXTURE (cogl_texture_2d_new_with_size (ctx, width, height));
+          level->framebuffer =
+            COGL_FRAMEBUFFER (cogl_offscreen_new_with_texture (level->texture));
+
+          if (!cogl_framebuffer_allocate (level->framebuffer, &error))
+            {
+              g_warning ("%s: Unable to allocate blur buffer: %s",
+                         G_STRLOC, error->message);
+              clear_blur_levels (self);
+              return FALSE;
+            }
+
+          cogl_framebuffer_orthographic (level->framebuffer,
+                                         0, 0, width, height,
+                                         -1.f, 1.f);
+
+          level->down_pipeline = cogl_pipeline_copy (klass->base_down_pipeline);
+          level->up_pipeline = cogl_pipeline_copy (klass->base_up_pipeline);
+
+          /* Only the first level is blended onto the paint target, the
+           * other levels replace the contents of the level above.
+           */
+          if (i > 0)
+            {
+              cogl_pipeline_set_blend (level->up_pipeline,
+                                       "RGBA = ADD (SRC_COLOR, 0)", NULL);
+            }
+        }
+
+      self->levels_width = self->tex_width;
+      self->levels_height = self->tex_height;
+    }
+
+  for (i = 0; i < self->n_levels; i++)
+    {
+      BlurLevel *level = &self->levels[i];
+
+      setup_level_pipeline (level->down_pipeline,
+                            i == 0 ? source : self->levels[i - 1].texture,
+                            offset);
+      setup_level_pipeline (level->up_pipeline, level->texture, offset);
+    }
+
+  return TRUE;
+}
+
+static void
+draw_blur_level (CoglFramebuffer *framebuffer,
+                 CoglPipeline    *pipeline)
+{
+  cogl_framebuffer_draw_textured_rectangle (framebuffer,
+                                            pipeline,
+                                            0, 0,
+                                            cogl_framebuffer_get_width (framebuffer),
+                                            cogl_framebuffer_get_height (framebuffer),
+                                            0, 0, 1, 1);
+
+  /* Level textures are read back by the next pass, and rendered into
+   * again later on, so make sure the passes run in order.
+   */
+  cogl_framebuffer_flush (framebuffer);
+}
+
+static void
+update_blur_levels (ClutterBlurEffect *self)
+{
+  int i;
+
+  for (i = 0; i < self->n_levels; i++)
+    draw_blur_level (self->levels[i].framebuffer,
+                     self->levels[i].down_pipeline);
+
+  for (i = self->n_levels - 1; i > 0; i--)
+    draw_blur_level (self->levels[i - 1].framebuffer,
+                     self->levels[i].up_pipeline);
+
+  self->blur_dirty = FALSE;
+}
+
+static float
+get_blur_padding (ClutterBlurEffect *self)
+{
+  if (self->radius > 0.f)
+    return ceilf (self->radius);
+  else
+    return BLUR_PADDING;
+}
+
 static gboolean
 clutter_blur_effect_pre_paint (ClutterEffect       *effect,
                                ClutterPaintContext *paint_context)
@@ -135,6 +398,17 @@ clutter_blur_effect_pre_paint (ClutterEffect       *effect,
       self->tex_width = cogl_texture_get_width (texture);
       self->tex_height = cogl_texture_get_height (texture);
 
+      if (self->radius > 0.f)
+        {
+          /* The offscreen texture was redrawn, so the cached blur
+           * result is stale.
+           */
+          if (ensure_blur_levels (self, texture))
+            self->blur_dirty = TRUE;
+
+          return TRUE;
+        }
+
       if (self->pixel_step_uniform > -1)
         {
           gfloat pixel_step[2];
@@ -164,18 +438,35 @@ clutter_blur_effect_paint_target (ClutterOffscreenEffect *effect,
   ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (effect);
   CoglFramebuffer *framebuffer =
     clutter_paint_context_get_framebuffer (paint_context);
+  CoglPipeline *pipeline;
   guint8 paint_opacity;
 
+  if (self->radius > 0.f)
+    {
+      if (self->n_levels == 0)
+        return;
+
+      if (self->blur_dirty)
+        update_blur_levels (self);
+
+      /* The last upsampling step goes straight to the paint target */
+      pipeline = self->levels[0].up_pipeline;
+    }
+  else
+    {
+      pipeline = self->pipeline;
+    }
+
   paint_opacity = clutter_actor_get_paint_opacity (self->actor);
 
-  cogl_pipeline_set_color4ub (self->pipeline,
+  cogl_pipeline_set_color4ub (pipeline,
                               paint_opacity,
                               paint_opacity,
                               paint_opacity,
                               paint_opacity);
 
   cogl_framebuffer_draw_rectangle (framebuffer,
-                                   self->pipeline,
+                                   pipeline,
                                    0, 0,
                                    self->tex_width, self->tex_height);
 }
@@ -184,17 +475,21 @@ static gboolean
 clutter_blur_effect_modify_paint_volume (ClutterEffect      *effect,
                                          ClutterPaintVolume *volume)
 {
+  ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (effect);
   gfloat cur_width, cur_height;
+  gfloat padding;
   graphene_point3d_t origin;
 
   clutter_paint_volume_get_origin (volume, &origin);
   cur_width = clutter_paint_volume_get_width (volume);
   cur_height = clutter_paint_volume_get_height (volume);
 
-  origin.x -= BLUR_PADDING;
-  origin.y -= BLUR_PADDING;
-  cur_width += 2 * BLUR_PADDING;
-  cur_height += 2 * BLUR_PADDING;
+  padding = get_blur_padding (self);
+
+  origin.x -= padding;
+  origin.y -= padding;
+  cur_width += 2 * padding;
+  cur_height += 2 * padding;
   clutter_paint_volume_set_origin (volume, &origin);
   clutter_paint_volume_set_width (volume, cur_width);
   clutter_paint_volume_set_height (volume, cur_height);
@@ -213,9 +508,51 @@ clutter_blur_effect_dispose (GObject *gobject)
       self->pipeline = NULL;
     }
 
+  clear_blur_levels (self);
+
   G_OBJECT_CLASS (clutter_blur_effect_parent_class)->dispose (gobject);
 }
 
+static void
+clutter_blur_effect_set_property (GObject      *gobject,
+                                  guint         prop_id,
+                                  const GValue *value,
+                                  GParamSpec   *pspec)
+{
+  ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_RADIUS:
+      clutter_blur_effect_set_radius (self, g_value_get_float (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+clutter_blur_effect_get_property (GObject    *gobject,
+                                  guint       prop_id,
+                                  GValue     *value,
+                                  GParamSpec *pspec)
+{
+  ClutterBlurEffect *self = CLUTTER_BLUR_EFFECT (gobject);
+
+  switch (prop_id)
+    {
+    case PROP_RADIUS:
+      g_value_set_float (value, self->radius);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (gobject, prop_id, pspec);
+      break;
+    }
+}
+
 static void
 clutter_blur_effect_class_init (ClutterBlurEffectClass *klass)
 {
@@ -224,12 +561,57 @@ clutter_blur_effect_class_init (ClutterBlurEffectClass *klass)
   ClutterOffscreenEffectClass *offscreen_class;
 
   gobject_class->dispose = clutter_blur_effect_dispose;
+  gobject_class->set_property = clutter_blur_effect_set_property;
+  gobject_class->get_property = clutter_blur_effect_get_property;
 
   effect_class->pre_paint = clutter_blur_effect_pre_paint;
   effect_class->modify_paint_volume = clutter_blur_effect_modify_paint_volume;
 
   offscreen_class = CLUTTER_OFFSCREEN_EFFECT_CLASS (klass);
   offscreen_class->paint_target = clutter_blur_effect_paint_target;
+
+  /**
+   * ClutterBlurEffect:radius:
+   *
+   * The radius of the blur, in pixels. A radius of 0 uses a fixed 3x3
+   * box blur; a positive radius uses a downsampling dual Kawase blur of
+   * roughly that radius.
+   */
+  obj_props[PROP_RADIUS] =
+    g_param_spec_float ("radius",
+                        P_("Radius"),
+                        P_("The radius of the blur"),
+                        0.f, G_MAXFLOAT,
+                        0.f,
+                        CLUTTER_PARAM_READWRITE);
+
+  g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
+}
+
+static CoglPipeline *
+create_kawase_pipeline (CoglContext *ctx,
+                        const char  *shader)
+{
+  CoglPipeline *pipeline;
+  CoglSnippet *snippet;
+
+  pipeline = cogl_pipeline_new (ctx);
+
+  snippet = cogl_snippet_new (COGL_SNIPPET_HOOK_TEXTURE_LOOKUP,
+                              kawase_blur_glsl_declarations,
+                              NULL);
+  cogl_snippet_set_replace (snippet, shader);
+  cogl_pipeline_add_layer_snippet (pipeline, 0, snippet);
+  cogl_object_unref (snippet);
+
+  cogl_pipeline_set_layer_null_texture (pipeline, 0);
+  cogl_pipeline_set_layer_filters (pipeline, 0,
+                                   COGL_PIPELINE_FILTER_LINEAR,
+                                   COGL_PIPELINE_FILTER_LINEAR);
+  cogl_pipeline_set_layer_wrap_mode (pipeline, 0,
+                                     COGL_PIPELINE_WRAP_MODE_CLAMP_TO_EDGE);
+
+  return pipeline;
 }
 
 static void
@@ -253,6 +635,17 @@ clutter_blur_effect_init (ClutterBlurEffect *self)
       cogl_object_unref (snippet);
 
       cogl_pipeline_set_layer_null_texture (klass->base_pipeline, 0);
+
+      klass->base_down_pipeline =
+        create_kawase_pipeline (ctx, kawase_downsample_glsl_shader);
+      /* Intermediate passes replace the contents of the level they
+       * render into.
+       */
+      cogl_pipeline_set_blend (klass->base_down_pipeline,
+                               "RGBA = ADD (SRC_COLOR, 0)", NULL);
+
+      klass->base_up_pipeline =
+        create_kawase_pipeline (ctx, kawase_upsample_glsl_shader);
     }
 
   self->pipeline = cogl_pipeline_copy (klass->base_pipeline);
@@ -276,3 +669,54 @@ clutter_blur_effect_new (void)
 {
   return g_object_new (CLUTTER_TYPE_BLUR_EFFECT, NULL);
 }
+
+/**
+ * clutter_blur_effect_set_radius:
+ * @effect: a #ClutterBlurEffect
+ * @radius: the radius of the blur, in pixels
+ *
+ * Sets the radius of the blur. A radius of 0 uses the fixed 3x3 box blur.
+ */
+void
+clutter_blur_effect_set_radius (ClutterBlurEffect *effect,
+                                float              radius)
+{
+  ClutterActor *actor;
+
+  g_return_if_fail (CLUTTER_IS_BLUR_EFFECT (effect));
+  g_return_if_fail (radius >= 0.f);
+
+  if (G_APPROX_VALUE (effect->radius, radius, FLT_EPSILON))
+    return;
+
+  effect->radius = radius;
+  effect->blur_dirty = TRUE;
+
+  if (radius == 0.f)
+    clear_blur_levels (effect);
+
+  /* The padding around the actor depends on the radius, so the offscreen
+   * texture needs to be redrawn as well.
+   */
+  actor = clutter_actor_meta_get_actor (CLUTTER_ACTOR_META (effect));
+  if (actor)
+    clutter_actor_queue_redraw (actor);
+
+  g_object_notify_by_pspec (G_OBJECT (effect), obj_props[PROP_RADIUS]);
+}
+
+/**
+ * clutter_blur_effect_get_radius:
+ * @effect: a #ClutterBlurEffect
+ *
+ * Retrieves the radius of the blur.
+ *
+ * Return value: the radius of the blur, in pixels
+ */
+float
+clutter_blur_effect_get_radius (ClutterBlurEffect *effect)
+{
+  g_return_val_if_fail (CLUTTER_IS_BLUR_EFFECT (effect), 0.f);
+
+  return effect->radius;
+}
@@ -54,6 +54,13 @@ GType clutter_blur_effect_get_type (void) G_GNUC_CONST;
 CLUTTER_EXPORT
 ClutterEffect *clutter_blur_effect_new (void);
 
+CLUTTER_EXPORT
+void clutter_blur_effect_set_radius (ClutterBlurEffect *effect,
+                                     float              radius);
+
+CLUTTER_EXPORT
+float clutter_blur_effect_get_radius (ClutterBlurEffect *effect);
+
 G_END_DECLS
 
 #endif /* __CLUTTER_BLUR_EFFECT_H__ */
@@ -175,7 +175,7 @@ clutter_clone_paint (ClutterActor        *actor,
    */
   if (clutter_actor_is_realized (priv->clone_source))
     {
-      _clutter_actor_push_clone_paint ();
+      _clutter_actor_push_clone_paint (actor, priv->clone_source);
       clutter_actor_paint (priv->clone_source, paint_context);
       _clutter_actor_pop_clone_paint ();
     }
@@ -0,0 +1,356 @@
+/*
+ * Copyright (C) 2020 Endless Mobile, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "clutter-build-config.h"
+
+#include "clutter/clutter-damage-tiles.h"
+
+#include <string.h>
+
+#define SMALL_TILE_SIZE 16
+#define LARGE_TILE_SIZE 32
+
+/*
+ * Use larger tiles when a large part of the framebuffer is damaged, where
+ * the per tile overhead dominates and fine grained damage matters less.
+ */
+#define LARGE_TILE_DAMAGE_FRACTION 4
+
+/* Damage smaller than this is compared without involving worker threads. */
+#define MIN_PARALLEL_PIXELS (512 * 512)
+
+#define MAX_WORKER_THREADS 7
+
+typedef enum _TileState
+{
+  TILE_STATE_CLEAN,
+  TILE_STATE_DIRTY,
+  TILE_STATE_SKIPPED,
+} TileState;
+
+typedef struct _TileDiff
+{
+  const cairo_region_t *damage_region;
+  const uint8_t *current_data;
+  const uint8_t *prev_data;
+  int width;
+  int height;
+  int stride;
+  int bpp;
+
+  int tile_size;
+  int tile_x_min;
+  int tile_y_min;
+  int n_tiles_x;
+  int n_tiles_y;
+  uint8_t *tile_states;
+
+  GMutex mutex;
+  GCond cond;
+  int n_pending_jobs;
+} TileDiff;
+
+typedef struct _TileDiffJob
+{
+  TileDiff *diff;
+  int tile_row_start;
+  int tile_row_end;
+} TileDiffJob;
+
+static GThreadPool *diff_thread_pool;
+static int n_diff_workers = -1;
+
+static void
+diff_tile_row (TileDiff *diff,
+               int       tile_row)
+{
+  int tile_size = diff->tile_size;
+  int bpp = diff->bpp;
+  uint8_t *tile_states = &diff->tile_states[tile_row * diff->n_tiles_x];
+  int y_start, y_end;
+  int x_start, x_end;
+  int n_candidates = 0;
+  int i;
+  int y;
+
+  y_start = (diff->tile_y_min + tile_row) * tile_size;
+  y_end = MIN (y_start + tile_size, diff->height);
+  x_start = diff->tile_x_min * tile_size;
+  x_end = MIN ((diff->tile_x_min + diff->n_tiles_x) * tile_size, diff->width);
+
+  for (i = 0; i < diff->n_tiles_x; i++)
+    {
+      cairo_rectangle_int_t tile = {
+        .x = (diff->tile_x_min + i) * tile_size,
+        .y = y_start,
+        .width = tile_size,
+        .height = tile_size,
+      };
+
+      if (cairo_region_contains_rectangle (diff->damage_region, &tile) ==
+          CAIRO_REGION_OVERLAP_OUT)
+        {
+          tile_states[i] = TILE_STATE_SKIPPED;
+          continue;
+        }
+
+      tile_states[i] = TILE_STATE_CLEAN;
+      n_candidates++;
+    }
+
+  /*
+   * First compare whole rows spanning all tiles in one go, which lets the
+   * vectorized memcmp() run over long spans; most rows are usually
+   * identical. Only when a row differs, find out which tiles it touches.
+   */
+  for (y = y_start; y < y_end && n_candidates > 0; y++)
+    {
+      size_t row_offset = (size_t) y * diff->stride;
+
+      if (memcmp (diff->prev_data + row_offset + x_start * bpp,
+                  diff->current_data + row_offset + x_start * bpp,
+                  (x_end - x_start) * bpp) == 0)
+        continue;
+
+      for (i = 0; i < diff->n_tiles_x; i++)
+        {
+          int tile_x_start;
+          int tile_x_end;
+
+          if (tile_states[i] != TILE_STATE_CLEAN)
+            continue;
+
+          tile_x_start = (diff->tile_x_min + i) * tile_size;
+          tile_x_end = MIN (tile_x_start + tile_size, diff->width);
+
+          if (memcmp (diff->prev_data + row_offset + tile_x_start * bpp,
+                      diff->current_data + row_offset + tile_x_start * bpp,
+                      (tile_x_end - tile_x_start) * bpp) != 0)
+            {
+              tile_states[i] = TILE_STATE_DIRTY;
+              n_candidates--;
+            }
+        }
+    }
+}
+
+static void
+run_diff_job (TileDiffJob *job)
+{
+  int tile_row;
+
+  for (tile_row = job->tile_row_start; tile_row < job->tile_row_end; tile_row++)
+    diff_tile_row (job->diff, tile_row);
+}
+
+static void
+diff_job_thread_func (gpointer data,
+                      gpointer user_data)
+{
+  TileDiffJob *job = data;
+  TileDiff *diff = job->diff;
+
+  run_diff_job (job);
+
+  g_mutex_lock (&diff->mutex);
+  diff->n_pending_jobs--;
+  if (diff->n_pending_jobs == 0)
+    g_cond_signal (&diff->cond);
+  g_mutex_unlock (&diff->mutex);
+}
+
+static gboolean
+ensure_diff_thread_pool (void)
+{
+  if (n_diff_workers == -1)
+    {
+      n_diff_workers = CLAMP ((int) g_get_num_processors () - 1,
+                              0, MAX_WORKER_THREADS);
+      if (n_diff_workers > 0)
+        {
+          diff_thread_pool = g_thread_pool_new (diff_job_thread_func,
+                                                NULL,
+                                                n_diff_workers,
+                                                FALSE,
+                                                NULL);
+        }
+    }
+
+  return diff_thread_pool != NULL;
+}
+
+static void
+run_diff (TileDiff *diff)
+{
+  g_autofree TileDiffJob *jobs = NULL;
+  int n_jobs;
+  int rows_per_job;
+  int i;
+
+  if ((int64_t) diff->n_tiles_x * diff->n_tiles_y *
+      diff->tile_size * diff->tile_size < MIN_PARALLEL_PIXELS ||
+      !ensure_diff_thread_pool ())
+    {
+      TileDiffJob job = {
+        .diff = diff,
+        .tile_row_start = 0,
+        .tile_row_end = diff->n_tiles_y,
+      };
+
+      run_diff_job (&job);
+      return;
+    }
+
+  n_jobs = MIN (n_diff_workers + 1, diff->n_tiles_y);
+  rows_per_job = (diff->n_tiles_y + n_jobs - 1) / n_jobs;
+  n_jobs = (diff->n_tiles_y + rows_per_job - 1) / rows_per_job;
+
+  jobs = g_new0 (TileDiffJob, n_jobs);
+  for (i = 0; i < n_jobs; i++)
+    {
+      jobs[i] = (TileDiffJob) {
+        .diff = diff,
+        .tile_row_start = i * rows_per_job,
+        .tile_row_end = MIN ((i + 1) * rows_per_job, diff->n_tiles_y),
+      };
+    }
+
+  g_mutex_init (&diff->mutex);
+  g_cond_init (&diff->cond);
+  diff->n_pending_jobs = n_jobs - 1;
+
+  for (i = 1; i < n_jobs; i++)
+    g_thread_pool_push (diff_thread_pool, &jobs[i], NULL);
+
+  /* The calling thread takes the first share of the work. */
+  run_diff_job (&jobs[0]);
+
+  g_mutex_lock (&diff->mutex);
+  while (diff->n_pending_jobs > 0)
+    g_cond_wait (&diff->cond, &diff->mutex);
+  g_mutex_unlock (&diff->mutex);
+
+  g_cond_clear (&diff->cond);
+  g_mutex_clear (&diff->mutex);
+}
+
+static cairo_region_t *
+build_tile_damage_region (TileDiff *diff)
+{
+  cairo_region_t *region;
+  int tile_row;
+
+  region = cairo_region_create ();
+
+  for (tile_row = 0; tile_row < diff->n_tiles_y; tile_row++)
+    {
+      uint8_t *tile_states = &diff->tile_states[tile_row * diff->n_tiles_x];
+      int i = 0;
+
+      while (i < diff->n_tiles_x)
+        {
+          cairo_rectangle_int_t rect;
+          int run_start;
+
+          if (tile_states[i] != TILE_STATE_DIRTY)
+            {
+              i++;
+              continue;
+            }
+
+          /* Merge horizontal runs of dirty tiles into a single rectangle. */
+          run_start = i;
+          while (i < diff->n_tiles_x && tile_states[i] == TILE_STATE_DIRTY)
+            i++;
+
+          rect = (cairo_rectangle_int_t) {
+            .x = (diff->tile_x_min + run_start) * diff->tile_size,
+            .y = (diff->tile_y_min + tile_row) * diff->tile_size,
+          };
+          /* Tiles at the right and bottom edges may be partial. */
+          rect.width = MIN ((diff->tile_x_min + i) * diff->tile_size,
+                            diff->width) - rect.x;
+          rect.height = MIN (rect.y + diff->tile_size, diff->height) - rect.y;
+          cairo_region_union_rectangle (region, &rect);
+        }
+    }
+
+  return region;
+}
+
+/*
+ * Compares the damaged parts of two framebuffer contents tile by tile, and
+ * returns the part of @damage_region that actually changed.
+ */
+cairo_region_t *
+clutter_damage_tiles_find (const cairo_region_t *damage_region,
+                           const uint8_t        *current_data,
+                           const uint8_t        *prev_data,
+                           int                   width,
+                           int                   height,
+                           int                   stride,
+                           int                   bpp)
+{
+  g_autofree uint8_t *tile_states = NULL;
+  cairo_region_t *tile_damage_region;
+  cairo_rectangle_int_t damage_extents;
+  TileDiff diff;
+  int tile_size;
+  int tile_x_max, tile_y_max;
+
+  cairo_region_get_extents (damage_region, &damage_extents);
+
+  if ((int64_t) damage_extents.width * damage_extents.height >
+      (int64_t) width * height / LARGE_TILE_DAMAGE_FRACTION)
+    tile_size = LARGE_TILE_SIZE;
+  else
+    tile_size = SMALL_TILE_SIZE;
+
+  diff = (TileDiff) {
+    .damage_region = damage_region,
+    .current_data = current_data,
+    .prev_data = prev_data,
+    .width = width,
+    .height = height,
+    .stride = stride,
+    .bpp = bpp,
+    .tile_size = tile_size,
+  };
+
+  diff.tile_x_min = MAX (damage_extents.x, 0) / tile_size;
+  diff.tile_y_min = MAX (damage_extents.y, 0) / tile_size;
+  tile_x_max = MIN (damage_extents.x + damage_extents.width, width);
+  tile_x_max = (tile_x_max + tile_size - 1) / tile_size;
+  tile_y_max = MIN (damage_extents.y + damage_extents.height, height);
+  tile_y_max = (tile_y_max + tile_size - 1) / tile_size;
+
+  if (tile_x_max <= diff.tile_x_min || tile_y_max <= diff.tile_y_min)
+    return cairo_region_create ();
+
+  diff.n_tiles_x = tile_x_max - diff.tile_x_min;
+  diff.n_tiles_y = tile_y_max - diff.tile_y_min;
+
+  tile_states = g_malloc (diff.n_tiles_x * diff.n_tiles_y);
+  diff.tile_states = tile_states;
+
+  run_diff (&diff);
+
+  tile_damage_region = build_tile_damage_region (&diff);
+  cairo_region_intersect (tile_damage_region, damage_region);
+
+  return tile_damage_region;
+}
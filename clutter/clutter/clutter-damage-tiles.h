@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2020 Endless Mobile, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CLUTTER_DAMAGE_TILES_H
+#define CLUTTER_DAMAGE_TILES_H
+
+#include <cairo.h>
+#include <glib.h>
+#include <stdint.h>
+
+cairo_region_t * clutter_damage_tiles_find (const cairo_region_t *damage_region,
+                                            const uint8_t        *current_data,
+                                            const uint8_t        *prev_data,
+                                            int                   width,
+                                            int                   height,
+                                            int                   stride,
+                                            int                   bpp);
+
+#endif /* CLUTTER_DAMAGE_TILES_H */
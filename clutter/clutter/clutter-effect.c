@@ -68,6 +68,8 @@
  * The %CLUTTER_EFFECT_PAINT_ACTOR_DIRTY flag is useful in this case. Clutter will set
  * this flag when a redraw has been queued on the actor since it was last painted. The
  * effect can use this information to decide if the cached image is still valid.
+ * Redraws queued because only the transformation of the actor changed, for example
+ * its translation, scale or rotation, do not set this flag.
  *
  * ## A simple ClutterEffect implementation
  *
@@ -19,6 +19,7 @@
 
 #include "clutter/clutter-frame-clock.h"
 
+#include "clutter/clutter-actor-private.h"
 #include "clutter/clutter-main.h"
 #include "clutter/clutter-private.h"
 #include "clutter/clutter-timeline-private.h"
@@ -80,7 +81,12 @@ struct _ClutterFrameClock
 
   int inhibit_count;
 
-  GList *timelines;
+  /* Timelines in the order they were added */
+  GPtrArray *timelines;
+  /* Referenced copy of the timelines being advanced, kept across frames
+   * to avoid reallocating it every frame
+   */
+  GPtrArray *advancing_timelines;
 };
 
 G_DEFINE_TYPE (ClutterFrameClock, clutter_frame_clock,
@@ -98,12 +104,12 @@ clutter_frame_clock_add_timeline (ClutterFrameClock *frame_clock,
 {
   gboolean is_first;
 
-  if (g_list_find (frame_clock->timelines, timeline))
+  if (g_ptr_array_find (frame_clock->timelines, timeline, NULL))
     return;
 
-  is_first = !frame_clock->timelines;
+  is_first = frame_clock->timelines->len == 0;
 
-  frame_clock->timelines = g_list_prepend (frame_clock->timelines, timeline);
+  g_ptr_array_add (frame_clock->timelines, timeline);
 
   if (is_first)
     clutter_frame_clock_schedule_update (frame_clock);
@@ -113,15 +119,15 @@ void
 clutter_frame_clock_remove_timeline (ClutterFrameClock *frame_clock,
                                      ClutterTimeline   *timeline)
 {
-  frame_clock->timelines = g_list_remove (frame_clock->timelines, timeline);
+  g_ptr_array_remove (frame_clock->timelines, timeline);
 }
 
 static void
 advance_timelines (ClutterFrameClock *frame_clock,
                    int64_t            time_us)
 {
-  GList *timelines;
-  GList *l;
+  GPtrArray *timelines = frame_clock->advancing_timelines;
+  unsigned int i;
 
   /* we protect ourselves from timelines being removed during
    * the advancement by other timelines by copying the list of
@@ -142,26 +148,43 @@ advance_timelines (ClutterFrameClock *frame_clock,
    * a timeline might be removed as the direct result of do_tick()
    * and remove_timeline() would not find the timeline, failing
    * and leaving a dangling pointer behind.
+   *
+   * the most recently added timelines are advanced first.
    */
 
-  timelines = g_list_copy (frame_clock->timelines);
-  g_list_foreach (timelines, (GFunc) g_object_ref, NULL);
+  g_ptr_array_set_size (timelines, frame_clock->timelines->len);
+  for (i = 0; i < frame_clock->timelines->len; i++)
+    {
+      ClutterTimeline *timeline =
+        g_ptr_array_index (frame_clock->timelines,
+                           frame_clock->timelines->len - i - 1);
+
+      g_ptr_array_index (timelines, i) = g_object_ref (timeline);
+    }
+
+  /* Animated actors emit their property notifications once all timelines
+   * have been advanced, instead of once for each animated property.
+   */
+  _clutter_actor_begin_animation_batch ();
 
-  for (l = timelines; l; l = l->next)
+  for (i = 0; i < timelines->len; i++)
     {
-      ClutterTimeline *timeline = l->data;
+      ClutterTimeline *timeline = g_ptr_array_index (timelines, i);
 
       _clutter_timeline_do_tick (timeline, time_us / 1000);
     }
 
-  g_list_free_full (timelines, g_object_unref);
+  _clutter_actor_end_animation_batch ();
+
+  /* drops the references */
+  g_ptr_array_set_size (timelines, 0);
 }
 
 static void
 maybe_reschedule_update (ClutterFrameClock *frame_clock)
 {
   if (frame_clock->pending_reschedule ||
-      frame_clock->timelines)
+      frame_clock->timelines->len > 0)
     {
       frame_clock->pending_reschedule = FALSE;
 
@@ -312,6 +335,12 @@ clutter_frame_clock_uninhibit (ClutterFrameClock *frame_clock)
     maybe_reschedule_update (frame_clock);
 }
 
+gboolean
+clutter_frame_clock_is_inhibited (ClutterFrameClock *frame_clock)
+{
+  return frame_clock->inhibit_count > 0;
+}
+
 void
 clutter_frame_clock_schedule_update_now (ClutterFrameClock *frame_clock)
 {
@@ -526,10 +555,25 @@ clutter_frame_clock_dispose (GObject *object)
   G_OBJECT_CLASS (clutter_frame_clock_parent_class)->dispose (object);
 }
 
+static void
+clutter_frame_clock_finalize (GObject *object)
+{
+  ClutterFrameClock *frame_clock = CLUTTER_FRAME_CLOCK (object);
+
+  g_ptr_array_unref (frame_clock->timelines);
+  g_ptr_array_unref (frame_clock->advancing_timelines);
+
+  G_OBJECT_CLASS (clutter_frame_clock_parent_class)->finalize (object);
+}
+
 static void
 clutter_frame_clock_init (ClutterFrameClock *frame_clock)
 {
   frame_clock->state = CLUTTER_FRAME_CLOCK_STATE_INIT;
+
+  frame_clock->timelines = g_ptr_array_new ();
+  frame_clock->advancing_timelines =
+    g_ptr_array_new_with_free_func (g_object_unref);
 }
 
 static void
@@ -538,6 +582,7 @@ clutter_frame_clock_class_init (ClutterFrameClockClass *klass)
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
   object_class->dispose = clutter_frame_clock_dispose;
+  object_class->finalize = clutter_frame_clock_finalize;
 
   signals[DESTROY] =
     g_signal_new (I_("destroy"),
@@ -75,6 +75,9 @@ void clutter_frame_clock_inhibit (ClutterFrameClock *frame_clock);
 CLUTTER_EXPORT
 void clutter_frame_clock_uninhibit (ClutterFrameClock *frame_clock);
 
+CLUTTER_EXPORT
+gboolean clutter_frame_clock_is_inhibited (ClutterFrameClock *frame_clock);
+
 void clutter_frame_clock_add_timeline (ClutterFrameClock *frame_clock,
                                        ClutterTimeline   *timeline);
 
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2020 Endless Mobile, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CLUTTER_INTERVAL_PRIVATE_H
+#define CLUTTER_INTERVAL_PRIVATE_H
+
+#include "clutter/clutter-interval.h"
+
+gboolean clutter_interval_compute_float (ClutterInterval *interval,
+                                         double           factor,
+                                         float           *value);
+
+gboolean clutter_interval_compute_double (ClutterInterval *interval,
+                                          double           factor,
+                                          double          *value);
+
+gboolean clutter_interval_compute_uint (ClutterInterval *interval,
+                                        double           factor,
+                                        unsigned int    *value);
+
+gboolean clutter_interval_compute_color (ClutterInterval *interval,
+                                         double           factor,
+                                         ClutterColor    *value);
+
+gboolean clutter_interval_compute_point (ClutterInterval  *interval,
+                                         double            factor,
+                                         graphene_point_t *value);
+
+gboolean clutter_interval_compute_size (ClutterInterval *interval,
+                                        double           factor,
+                                        graphene_size_t *value);
+
+gboolean clutter_interval_compute_matrix (ClutterInterval *interval,
+                                          double           factor,
+                                          ClutterMatrix   *value);
+
+#endif /* CLUTTER_INTERVAL_PRIVATE_H */
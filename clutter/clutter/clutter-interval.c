@@ -54,6 +54,7 @@
 
 #include "clutter-color.h"
 #include "clutter-interval.h"
+#include "clutter-interval-private.h"
 #include "clutter-private.h"
 #include "clutter-units.h"
 #include "clutter-scriptable.h"
@@ -251,16 +252,15 @@ clutter_interval_real_compute_value (ClutterInterval *interval,
 
   value_type = clutter_interval_get_value_type (interval);
 
-  if (_clutter_has_progress_function (value_type))
-    {
-      retval = _clutter_run_progress_function (value_type,
-                                               initial,
-                                               final,
-                                               factor,
-                                               value);
-      if (retval)
-        return TRUE;
-    }
+  /* This fails without side effects if no progress function is registered
+   * for the type, so don't look it up twice.
+   */
+  if (_clutter_run_progress_function (value_type,
+                                      initial,
+                                      final,
+                                      factor,
+                                      value))
+    return TRUE;
 
   switch (G_TYPE_FUNDAMENTAL (value_type))
     {
@@ -1227,3 +1227,193 @@ clutter_interval_is_valid (ClutterInterval *interval)
   return G_IS_VALUE (&priv->values[INITIAL]) &&
          G_IS_VALUE (&priv->values[FINAL]);
 }
+
+/*
+ * Typed variants of clutter_interval_compute_value(), for callers that
+ * interpolate a value on every frame and would otherwise box and unbox it
+ * through a #GValue each time.
+ *
+ * They only apply to plain #ClutterInterval instances, which compute their
+ * value with the default implementation, and return %FALSE when the caller
+ * needs to use clutter_interval_compute_value() instead.
+ */
+static gboolean
+clutter_interval_get_typed_values (ClutterInterval  *interval,
+                                   GType             value_type,
+                                   const GValue    **initial,
+                                   const GValue    **final)
+{
+  ClutterIntervalPrivate *priv = interval->priv;
+
+  if (CLUTTER_INTERVAL_GET_CLASS (interval)->compute_value !=
+      clutter_interval_real_compute_value)
+    return FALSE;
+
+  if (priv->value_type != value_type)
+    return FALSE;
+
+  if (!G_IS_VALUE (&priv->values[INITIAL]) ||
+      !G_IS_VALUE (&priv->values[FINAL]))
+    return FALSE;
+
+  *initial = &priv->values[INITIAL];
+  *final = &priv->values[FINAL];
+
+  return TRUE;
+}
+
+static gboolean
+clutter_interval_get_fundamental_values (ClutterInterval  *interval,
+                                         GType             value_type,
+                                         const GValue    **initial,
+                                         const GValue    **final)
+{
+  /* Applications can override how fundamental types are interpolated */
+  if (_clutter_has_progress_function (value_type))
+    return FALSE;
+
+  return clutter_interval_get_typed_values (interval, value_type,
+                                            initial, final);
+}
+
+static gboolean
+clutter_interval_get_boxed_values (ClutterInterval  *interval,
+                                   GType             value_type,
+                                   gconstpointer    *initial,
+                                   gconstpointer    *final)
+{
+  const GValue *initial_value, *final_value;
+
+  if (!clutter_interval_get_typed_values (interval, value_type,
+                                          &initial_value, &final_value))
+    return FALSE;
+
+  *initial = g_value_get_boxed (initial_value);
+  *final = g_value_get_boxed (final_value);
+
+  return *initial != NULL && *final != NULL;
+}
+
+gboolean
+clutter_interval_compute_float (ClutterInterval *interval,
+                                double           factor,
+                                float           *value)
+{
+  const GValue *initial, *final;
+  double ia, ib;
+
+  if (!clutter_interval_get_fundamental_values (interval, G_TYPE_FLOAT,
+                                                &initial, &final))
+    return FALSE;
+
+  ia = g_value_get_float (initial);
+  ib = g_value_get_float (final);
+
+  *value = (factor * (ib - ia)) + ia;
+
+  return TRUE;
+}
+
+gboolean
+clutter_interval_compute_double (ClutterInterval *interval,
+                                 double           factor,
+                                 double          *value)
+{
+  const GValue *initial, *final;
+  double ia, ib;
+
+  if (!clutter_interval_get_fundamental_values (interval, G_TYPE_DOUBLE,
+                                                &initial, &final))
+    return FALSE;
+
+  ia = g_value_get_double (initial);
+  ib = g_value_get_double (final);
+
+  *value = (factor * (ib - ia)) + ia;
+
+  return TRUE;
+}
+
+gboolean
+clutter_interval_compute_uint (ClutterInterval *interval,
+                               double           factor,
+                               unsigned int    *value)
+{
+  const GValue *initial, *final;
+  unsigned int ia, ib;
+
+  if (!clutter_interval_get_fundamental_values (interval, G_TYPE_UINT,
+                                                &initial, &final))
+    return FALSE;
+
+  ia = g_value_get_uint (initial);
+  ib = g_value_get_uint (final);
+
+  *value = (factor * (ib - (double) ia)) + ia;
+
+  return TRUE;
+}
+
+gboolean
+clutter_interval_compute_color (ClutterInterval *interval,
+                                double           factor,
+                                ClutterColor    *value)
+{
+  gconstpointer initial, final;
+
+  if (!clutter_interval_get_boxed_values (interval, CLUTTER_TYPE_COLOR,
+                                          &initial, &final))
+    return FALSE;
+
+  clutter_color_interpolate (initial, final, factor, value);
+
+  return TRUE;
+}
+
+gboolean
+clutter_interval_compute_point (ClutterInterval  *interval,
+                                double            factor,
+                                graphene_point_t *value)
+{
+  gconstpointer initial, final;
+
+  if (!clutter_interval_get_boxed_values (interval, GRAPHENE_TYPE_POINT,
+                                          &initial, &final))
+    return FALSE;
+
+  graphene_point_interpolate (initial, final, factor, value);
+
+  return TRUE;
+}
+
+gboolean
+clutter_interval_compute_size (ClutterInterval *interval,
+                               double           factor,
+                               graphene_size_t *value)
+{
+  gconstpointer initial, final;
+
+  if (!clutter_interval_get_boxed_values (interval, GRAPHENE_TYPE_SIZE,
+                                          &initial, &final))
+    return FALSE;
+
+  graphene_size_interpolate (initial, final, factor, value);
+
+  return TRUE;
+}
+
+gboolean
+clutter_interval_compute_matrix (ClutterInterval *interval,
+                                 double           factor,
+                                 ClutterMatrix   *value)
+{
+  gconstpointer initial, final;
+
+  if (!clutter_interval_get_boxed_values (interval, CLUTTER_TYPE_MATRIX,
+                                          &initial, &final))
+    return FALSE;
+
+  _clutter_matrix_interpolate (initial, final, factor, value);
+
+  return TRUE;
+}
@@ -40,6 +40,11 @@
  * offscreen framebuffer, the redirection and the final paint of the texture on
  * the desired stage.
  *
+ * The contents of the offscreen framebuffer are kept between frames, and
+ * only painted again when the actor or one of its children queued a
+ * redraw; when only the position or transformation of the actor changed,
+ * just #ClutterOffscreenEffectClass.paint_target() is run again.
+ *
  * #ClutterOffscreenEffect is available since Clutter 1.4
  *
  * ## Implementing a ClutterOffscreenEffect
@@ -99,6 +104,12 @@ struct _ClutterOffscreenEffectPrivate
   int target_width;
   int target_height;
 
+  /* Whether offscreen was borrowed from the shared offscreen pool */
+  gboolean offscreen_pooled;
+
+  /* The resource scale the contents of offscreen were painted at */
+  float offscreen_resource_scale;
+
   gint old_opacity_override;
 
   gulong purge_handler_id;
@@ -108,6 +119,40 @@ G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (ClutterOffscreenEffect,
                                      clutter_offscreen_effect,
                                      CLUTTER_TYPE_EFFECT)
 
+static void
+release_offscreen (ClutterOffscreenEffect *self)
+{
+  ClutterOffscreenEffectPrivate *priv = self->priv;
+
+  if (priv->offscreen == NULL)
+    return;
+
+  if (priv->offscreen_pooled)
+    {
+      ClutterMainContext *context = _clutter_context_get_default ();
+
+      /* Drop our references to the texture so that it can actually be
+       * freed if the pool decides to trim it.
+       */
+      g_clear_pointer (&priv->texture, cogl_object_unref);
+      if (priv->pipeline)
+        cogl_pipeline_set_layer_null_texture (priv->pipeline, 0);
+
+      /* The pool is freed along with the backend */
+      if (context->offscreen_pool)
+        clutter_offscreen_pool_release (context->offscreen_pool,
+                                        g_steal_pointer (&priv->offscreen));
+      else
+        g_clear_pointer (&priv->offscreen, cogl_object_unref);
+
+      priv->offscreen_pooled = FALSE;
+    }
+  else
+    {
+      g_clear_pointer (&priv->offscreen, cogl_object_unref);
+    }
+}
+
 static void
 clutter_offscreen_effect_set_actor (ClutterActorMeta *meta,
                                     ClutterActor     *actor)
@@ -120,7 +165,7 @@ clutter_offscreen_effect_set_actor (ClutterActorMeta *meta,
   meta_class->set_actor (meta, actor);
 
   /* clear out the previous state */
-  g_clear_pointer (&priv->offscreen, cogl_object_unref);
+  release_offscreen (self);
 
   /* we keep a back pointer here, to avoid going through the ActorMeta */
   priv->actor = clutter_actor_meta_get_actor (meta);
@@ -163,7 +208,8 @@ ensure_pipeline_filter_for_scale (ClutterOffscreenEffect *self,
 static void
 video_memory_purged (ClutterOffscreenEffect *self)
 {
-  g_clear_pointer (&self->priv->offscreen, cogl_object_unref);
+  /* The stage purges the offscreen pool once all effects released theirs */
+  release_offscreen (self);
 }
 
 static gboolean
@@ -220,24 +266,55 @@ update_fbo (ClutterEffect *effect,
       ensure_pipeline_filter_for_scale (self, resource_scale);
     }
 
+  release_offscreen (self);
   g_clear_pointer (&priv->texture, cogl_object_unref);
-  g_clear_pointer (&priv->offscreen, cogl_object_unref);
 
-  priv->texture =
-    clutter_offscreen_effect_create_texture (self, target_width, target_height);
-  if (priv->texture == NULL)
-    return FALSE;
+  /* Render targets can only be shared when they are created the default
+   * way; subclasses overriding create_texture() get their own.
+   */
+  if (CLUTTER_OFFSCREEN_EFFECT_GET_CLASS (self)->create_texture ==
+      clutter_offscreen_effect_real_create_texture)
+    {
+      g_autoptr (GError) error = NULL;
+
+      priv->offscreen =
+        clutter_offscreen_pool_acquire (clutter_offscreen_pool_get_default (),
+                                        target_width, target_height,
+                                        &error);
+      if (priv->offscreen)
+        {
+          priv->offscreen_pooled = TRUE;
+          priv->texture =
+            cogl_object_ref (cogl_offscreen_get_texture (priv->offscreen));
+        }
+      else
+        {
+          g_warning ("%s: Unable to create an Offscreen buffer: %s",
+                     G_STRLOC, error->message);
+        }
+    }
+  else
+    {
+      priv->texture =
+        clutter_offscreen_effect_create_texture (self,
+                                                 target_width,
+                                                 target_height);
+      if (priv->texture == NULL)
+        return FALSE;
+
+      priv->offscreen = cogl_offscreen_new_to_texture (priv->texture);
+      if (priv->offscreen == NULL)
+        g_warning ("%s: Unable to create an Offscreen buffer", G_STRLOC);
+    }
 
-  cogl_pipeline_set_layer_texture (priv->pipeline, 0, priv->texture);
+  if (priv->texture)
+    cogl_pipeline_set_layer_texture (priv->pipeline, 0, priv->texture);
 
   priv->target_width = target_width;
   priv->target_height = target_height;
 
-  priv->offscreen = cogl_offscreen_new_to_texture (priv->texture);
   if (priv->offscreen == NULL)
     {
-      g_warning ("%s: Unable to create an Offscreen buffer", G_STRLOC);
-
       cogl_object_unref (priv->pipeline);
       priv->pipeline = NULL;
 
@@ -322,6 +399,8 @@ clutter_offscreen_effect_pre_paint (ClutterEffect       *effect,
   if (!update_fbo (effect, target_width, target_height, resource_scale))
     return FALSE;
 
+  priv->offscreen_resource_scale = ceiled_resource_scale;
+
   framebuffer = clutter_paint_context_get_framebuffer (paint_context);
   cogl_framebuffer_get_modelview_matrix (framebuffer, &old_modelview);
 
@@ -496,14 +575,20 @@ clutter_offscreen_effect_paint (ClutterEffect           *effect,
   if (flags & CLUTTER_EFFECT_PAINT_BYPASS_EFFECT)
     {
       clutter_actor_continue_paint (priv->actor, paint_context);
-      cogl_clear_object (&priv->offscreen);
+      release_offscreen (self);
       return;
     }
 
   /* If we've already got a cached image and the actor hasn't been redrawn
-   * then we can just use the cached image in the FBO.
+   * then we can just use the cached image in the FBO. Changes to the
+   * transformation of the actor alone don't make it dirty, as the actor
+   * is painted into the FBO without it; but moving to a monitor with a
+   * different scale still needs a new image.
    */
-  if (priv->offscreen == NULL || (flags & CLUTTER_EFFECT_PAINT_ACTOR_DIRTY))
+  if (priv->offscreen == NULL ||
+      (flags & CLUTTER_EFFECT_PAINT_ACTOR_DIRTY) ||
+      ceilf (clutter_actor_get_real_resource_scale (priv->actor)) !=
+      priv->offscreen_resource_scale)
     {
       ClutterEffectClass *effect_class = CLUTTER_EFFECT_GET_CLASS (effect);
       gboolean pre_paint_succeeded;
@@ -515,7 +600,7 @@ clutter_offscreen_effect_paint (ClutterEffect           *effect,
       if (pre_paint_succeeded)
         effect_class->post_paint (effect, paint_context);
       else
-        g_clear_pointer (&priv->offscreen, cogl_object_unref);
+        release_offscreen (self);
     }
   else
     clutter_offscreen_effect_paint_texture (self, paint_context);
@@ -528,9 +613,8 @@ clutter_offscreen_effect_set_enabled (ClutterActorMeta *meta,
   ClutterActorMetaClass *parent_class =
     CLUTTER_ACTOR_META_CLASS (clutter_offscreen_effect_parent_class);
   ClutterOffscreenEffect *offscreen_effect = CLUTTER_OFFSCREEN_EFFECT (meta);
-  ClutterOffscreenEffectPrivate *priv = offscreen_effect->priv;
 
-  g_clear_pointer (&priv->offscreen, cogl_object_unref);
+  release_offscreen (offscreen_effect);
 
   parent_class->set_enabled (meta, is_enabled);
 }
@@ -541,7 +625,7 @@ clutter_offscreen_effect_finalize (GObject *gobject)
   ClutterOffscreenEffect *self = CLUTTER_OFFSCREEN_EFFECT (gobject);
   ClutterOffscreenEffectPrivate *priv = self->priv;
 
-  g_clear_pointer (&priv->offscreen, cogl_object_unref);
+  release_offscreen (self);
   g_clear_pointer (&priv->texture, cogl_object_unref);
   g_clear_pointer (&priv->pipeline, cogl_object_unref);
 
@@ -0,0 +1,333 @@
+/*
+ * Copyright (C) 2020 Endless Mobile, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * A pool of offscreen render targets shared by everything drawing through
+ * a #CoglContext, currently #ClutterOffscreenEffect. Render targets that
+ * are no longer used are kept around in per size buckets for a little
+ * while, so that an effect being reallocated, or another effect needing a
+ * target of the same size, does not have to allocate a new one.
+ *
+ * Unused render targets are trimmed in least recently used order, when
+ * they have not been used for a few seconds or when the pool grows above
+ * its memory budget.
+ */
+
+#include "clutter-build-config.h"
+
+#include "clutter/clutter-offscreen-pool.h"
+
+#include "clutter/clutter-debug.h"
+#include "clutter/clutter-private.h"
+
+/* Unused render targets are destroyed after this long */
+#define MAX_IDLE_US (G_USEC_PER_SEC * 3)
+
+/* Maximum amount of memory kept in unused render targets */
+#define MAX_POOLED_BYTES (64 * 1024 * 1024)
+
+#define TRIM_INTERVAL_S 1
+
+#define BYTES_PER_PIXEL 4
+
+typedef struct _PooledTarget
+{
+  CoglOffscreen *offscreen;
+  int width;
+  int height;
+
+  int64_t release_time_us;
+
+  GList lru_link;
+} PooledTarget;
+
+struct _ClutterOffscreenPool
+{
+  CoglContext *cogl_context;
+
+  /* Size -> GQueue of PooledTarget, most recently released first */
+  GHashTable *buckets;
+
+  /* All pooled targets, most recently released first */
+  GQueue lru;
+
+  guint trim_source_id;
+
+  ClutterOffscreenPoolStats stats;
+};
+
+static gpointer
+size_to_key (int width,
+             int height)
+{
+  return GUINT_TO_POINTER (((guint) width << 16) | (guint) height);
+}
+
+static size_t
+get_target_bytes (PooledTarget *target)
+{
+  return (size_t) target->width * target->height * BYTES_PER_PIXEL;
+}
+
+static void
+pooled_target_free (PooledTarget *target)
+{
+  cogl_object_unref (target->offscreen);
+  g_free (target);
+}
+
+static void
+bucket_free (GQueue *bucket)
+{
+  g_queue_free (bucket);
+}
+
+static void
+remove_target (ClutterOffscreenPool *pool,
+               PooledTarget         *target)
+{
+  GQueue *bucket;
+
+  bucket = g_hash_table_lookup (pool->buckets,
+                                size_to_key (target->width, target->height));
+  g_queue_remove (bucket, target);
+  if (g_queue_is_empty (bucket))
+    {
+      g_hash_table_remove (pool->buckets,
+                           size_to_key (target->width, target->height));
+    }
+
+  g_queue_unlink (&pool->lru, &target->lru_link);
+
+  pool->stats.n_pooled--;
+  pool->stats.pooled_bytes -= get_target_bytes (target);
+}
+
+static void
+trim_target (ClutterOffscreenPool *pool,
+             PooledTarget         *target)
+{
+  remove_target (pool, target);
+  pooled_target_free (target);
+
+  pool->stats.n_trimmed++;
+}
+
+static gboolean
+trim_timeout_cb (gpointer user_data)
+{
+  ClutterOffscreenPool *pool = user_data;
+
+  clutter_offscreen_pool_trim (pool, MAX_IDLE_US, MAX_POOLED_BYTES);
+
+  if (g_queue_is_empty (&pool->lru))
+    {
+      pool->trim_source_id = 0;
+      return G_SOURCE_REMOVE;
+    }
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+ensure_trim_source (ClutterOffscreenPool *pool)
+{
+  if (pool->trim_source_id)
+    return;
+
+  pool->trim_source_id = g_timeout_add_seconds (TRIM_INTERVAL_S,
+                                                trim_timeout_cb,
+                                                pool);
+  g_source_set_name_by_id (pool->trim_source_id,
+                           "[clutter] Offscreen pool trimming");
+}
+
+ClutterOffscreenPool *
+clutter_offscreen_pool_new (CoglContext *cogl_context)
+{
+  ClutterOffscreenPool *pool;
+
+  pool = g_new0 (ClutterOffscreenPool, 1);
+  pool->cogl_context = cogl_context;
+  pool->buckets = g_hash_table_new_full (NULL, NULL,
+                                         NULL,
+                                         (GDestroyNotify) bucket_free);
+  g_queue_init (&pool->lru);
+
+  return pool;
+}
+
+void
+clutter_offscreen_pool_free (ClutterOffscreenPool *pool)
+{
+  clutter_offscreen_pool_purge (pool);
+
+  g_clear_handle_id (&pool->trim_source_id, g_source_remove);
+  g_hash_table_destroy (pool->buckets);
+  g_free (pool);
+}
+
+ClutterOffscreenPool *
+clutter_offscreen_pool_get_default (void)
+{
+  ClutterMainContext *context = _clutter_context_get_default ();
+
+  if (G_UNLIKELY (!context->offscreen_pool))
+    {
+      CoglContext *cogl_context =
+        clutter_backend_get_cogl_context (context->backend);
+
+      context->offscreen_pool = clutter_offscreen_pool_new (cogl_context);
+    }
+
+  return context->offscreen_pool;
+}
+
+/*
+ * Returns an allocated offscreen framebuffer backed by a premultiplied
+ * RGBA texture of exactly @width x @height pixels. The contents are
+ * undefined. Hand it back with clutter_offscreen_pool_release() once it is
+ * no longer needed.
+ */
+CoglOffscreen *
+clutter_offscreen_pool_acquire (ClutterOffscreenPool  *pool,
+                                int                    width,
+                                int                    height,
+                                GError               **error)
+{
+  CoglOffscreen *offscreen;
+  CoglTexture *texture;
+  GQueue *bucket;
+
+  width = MAX (width, 1);
+  height = MAX (height, 1);
+
+  bucket = g_hash_table_lookup (pool->buckets, size_to_key (width, height));
+  if (bucket)
+    {
+      PooledTarget *target = g_queue_peek_head (bucket);
+
+      offscreen = g_steal_pointer (&target->offscreen);
+      remove_target (pool, target);
+      g_free (target);
+
+      /* The texture may still be sampled by rendering queued up for the
+       * previous user; make sure that has been submitted before it gets
+       * rendered into again.
+       */
+      cogl_flush ();
+
+      pool->stats.n_reused++;
+
+      return offscreen;
+    }
+
+  texture = COGL_TEXTURE (cogl_texture_2d_new_with_size (pool->cogl_context,
+                                                         width, height));
+  offscreen = cogl_offscreen_new_with_texture (texture);
+  cogl_object_unref (texture);
+
+  if (!cogl_framebuffer_allocate (COGL_FRAMEBUFFER (offscreen), error))
+    {
+      cogl_object_unref (offscreen);
+      return NULL;
+    }
+
+  pool->stats.n_allocated++;
+
+  CLUTTER_NOTE (MISC, "Allocated %dx%d offscreen (%" G_GUINT64_FORMAT
+                " allocated, %" G_GUINT64_FORMAT " reused)",
+                width, height,
+                pool->stats.n_allocated, pool->stats.n_reused);
+
+  return offscreen;
+}
+
+void
+clutter_offscreen_pool_release (ClutterOffscreenPool *pool,
+                                CoglOffscreen        *offscreen)
+{
+  CoglTexture *texture;
+  PooledTarget *target;
+  GQueue *bucket;
+  gpointer key;
+
+  texture = cogl_offscreen_get_texture (offscreen);
+
+  target = g_new0 (PooledTarget, 1);
+  target->offscreen = offscreen;
+  target->width = cogl_texture_get_width (texture);
+  target->height = cogl_texture_get_height (texture);
+  target->release_time_us = g_get_monotonic_time ();
+  target->lru_link.data = target;
+
+  key = size_to_key (target->width, target->height);
+  bucket = g_hash_table_lookup (pool->buckets, key);
+  if (!bucket)
+    {
+      bucket = g_queue_new ();
+      g_hash_table_insert (pool->buckets, key, bucket);
+    }
+
+  g_queue_push_head (bucket, target);
+  g_queue_push_head_link (&pool->lru, &target->lru_link);
+
+  pool->stats.n_pooled++;
+  pool->stats.pooled_bytes += get_target_bytes (target);
+
+  clutter_offscreen_pool_trim (pool, MAX_IDLE_US, MAX_POOLED_BYTES);
+
+  if (!g_queue_is_empty (&pool->lru))
+    ensure_trim_source (pool);
+}
+
+/*
+ * Destroys unused render targets that have been in the pool for longer than
+ * @max_idle_us, then the least recently used ones until at most @max_bytes
+ * are left.
+ */
+void
+clutter_offscreen_pool_trim (ClutterOffscreenPool *pool,
+                             int64_t               max_idle_us,
+                             size_t                max_bytes)
+{
+  int64_t now_us = g_get_monotonic_time ();
+
+  while (!g_queue_is_empty (&pool->lru))
+    {
+      PooledTarget *target = g_queue_peek_tail (&pool->lru);
+
+      if (now_us - target->release_time_us <= max_idle_us &&
+          pool->stats.pooled_bytes <= max_bytes)
+        break;
+
+      trim_target (pool, target);
+    }
+}
+
+void
+clutter_offscreen_pool_purge (ClutterOffscreenPool *pool)
+{
+  clutter_offscreen_pool_trim (pool, -1, 0);
+}
+
+void
+clutter_offscreen_pool_get_stats (ClutterOffscreenPool      *pool,
+                                  ClutterOffscreenPoolStats *stats)
+{
+  *stats = pool->stats;
+}
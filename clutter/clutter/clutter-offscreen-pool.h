@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2020 Endless Mobile, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CLUTTER_OFFSCREEN_POOL_H
+#define CLUTTER_OFFSCREEN_POOL_H
+
+#include <glib.h>
+
+#include "clutter/clutter-macros.h"
+#include "cogl/cogl.h"
+
+typedef struct _ClutterOffscreenPool ClutterOffscreenPool;
+
+typedef struct _ClutterOffscreenPoolStats
+{
+  /* Render targets created because no pooled one of the right size existed */
+  uint64_t n_allocated;
+  /* Render targets handed out again from the pool */
+  uint64_t n_reused;
+  /* Pooled render targets destroyed when trimming or purging the pool */
+  uint64_t n_trimmed;
+
+  /* Render targets currently sitting unused in the pool */
+  unsigned int n_pooled;
+  size_t pooled_bytes;
+} ClutterOffscreenPoolStats;
+
+CLUTTER_EXPORT
+ClutterOffscreenPool * clutter_offscreen_pool_new (CoglContext *cogl_context);
+
+CLUTTER_EXPORT
+void clutter_offscreen_pool_free (ClutterOffscreenPool *pool);
+
+CLUTTER_EXPORT
+ClutterOffscreenPool * clutter_offscreen_pool_get_default (void);
+
+CLUTTER_EXPORT
+CoglOffscreen * clutter_offscreen_pool_acquire (ClutterOffscreenPool  *pool,
+                                                int                    width,
+                                                int                    height,
+                                                GError               **error);
+
+CLUTTER_EXPORT
+void clutter_offscreen_pool_release (ClutterOffscreenPool *pool,
+                                     CoglOffscreen        *offscreen);
+
+CLUTTER_EXPORT
+void clutter_offscreen_pool_trim (ClutterOffscreenPool *pool,
+                                  int64_t               max_idle_us,
+                                  size_t                max_bytes);
+
+CLUTTER_EXPORT
+void clutter_offscreen_pool_purge (ClutterOffscreenPool *pool);
+
+CLUTTER_EXPORT
+void clutter_offscreen_pool_get_stats (ClutterOffscreenPool      *pool,
+                                       ClutterOffscreenPoolStats *stats);
+
+#endif /* CLUTTER_OFFSCREEN_POOL_H */
@@ -74,6 +74,15 @@ struct _ClutterPaintNodeClass
   JsonNode*(* serialize) (ClutterPaintNode *node);
 
   CoglFramebuffer *(* get_framebuffer) (ClutterPaintNode *node);
+
+  /*< private >*/
+  /* Freed instances of exactly this type, kept for reuse; only used by
+   * types that called clutter_paint_node_class_set_recyclable()
+   */
+  gboolean recyclable;
+  size_t instance_size;
+  ClutterPaintNode *free_nodes;
+  unsigned int n_free_nodes;
 };
 
 #define PAINT_OP_INIT   { PAINT_OP_INVALID }
@@ -109,6 +118,8 @@ void                    _clutter_paint_operation_clip_path              (const C
 void                    _clutter_paint_operation_paint_primitive        (const ClutterPaintOperation *op);
 
 void                    _clutter_paint_node_init_types                  (void);
+G_GNUC_INTERNAL
+void                    clutter_paint_node_class_set_recyclable         (ClutterPaintNodeClass *klass);
 gpointer                _clutter_paint_node_create                      (GType gtype);
 
 ClutterPaintNode *      _clutter_transform_node_new                     (const CoglMatrix            *matrix);
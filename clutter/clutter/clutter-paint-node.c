@@ -72,6 +72,7 @@
 #include "clutter-private.h"
 
 #include <gobject/gvaluecollector.h>
+#include <string.h>
 
 static inline void      clutter_paint_operation_clear   (ClutterPaintOperation *op);
 
@@ -156,9 +157,26 @@ value_paint_node_lcopy_value (const GValue *value,
   return NULL;
 }
 
+/* Upper bounds for the number of freed nodes of each recyclable type, and
+ * of operation arrays, kept around for reuse by the following frames.
+ */
+#define MAX_FREE_NODES_PER_TYPE 256
+#define MAX_FREE_OPERATION_ARRAYS 256
+
+static GArray *free_operation_arrays[MAX_FREE_OPERATION_ARRAYS];
+static unsigned int n_free_operation_arrays;
+
 static void
 clutter_paint_node_class_base_init (ClutterPaintNodeClass *klass)
 {
+  /* The class structure is copied from the parent class; recycling has to
+   * be enabled by each type individually, as it depends on its instance
+   * initialization.
+   */
+  klass->recyclable = FALSE;
+  klass->instance_size = 0;
+  klass->free_nodes = NULL;
+  klass->n_free_nodes = 0;
 }
 
 static void
@@ -169,6 +187,7 @@ clutter_paint_node_class_base_finalize (ClutterPaintNodeClass *klass)
 static void
 clutter_paint_node_real_finalize (ClutterPaintNode *node)
 {
+  ClutterPaintNodeClass *klass;
   ClutterPaintNode *iter;
 
   if (node->operations != NULL)
@@ -183,7 +202,15 @@ clutter_paint_node_real_finalize (ClutterPaintNode *node)
           clutter_paint_operation_clear (op);
         }
 
-      g_array_unref (node->operations);
+      if (n_free_operation_arrays < MAX_FREE_OPERATION_ARRAYS)
+        {
+          g_array_set_size (node->operations, 0);
+          free_operation_arrays[n_free_operation_arrays++] = node->operations;
+        }
+      else
+        {
+          g_array_unref (node->operations);
+        }
     }
 
   iter = node->first_child;
@@ -196,6 +223,15 @@ clutter_paint_node_real_finalize (ClutterPaintNode *node)
       iter = next;
     }
 
+  klass = CLUTTER_PAINT_NODE_GET_CLASS (node);
+  if (klass->recyclable && klass->n_free_nodes < MAX_FREE_NODES_PER_TYPE)
+    {
+      node->next_sibling = klass->free_nodes;
+      klass->free_nodes = node;
+      klass->n_free_nodes++;
+      return;
+    }
+
   g_type_free_instance ((GTypeInstance *) node);
 }
 
@@ -847,6 +883,12 @@ clutter_paint_node_maybe_init_operations (ClutterPaintNode *node)
   if (node->operations != NULL)
     return;
 
+  if (n_free_operation_arrays > 0)
+    {
+      node->operations = free_operation_arrays[--n_free_operation_arrays];
+      return;
+    }
+
   node->operations =
     g_array_new (FALSE, FALSE, sizeof (ClutterPaintOperation));
 }
@@ -1144,11 +1186,55 @@ _clutter_paint_node_dump_tree (ClutterPaintNode *node)
 gpointer
 _clutter_paint_node_create (GType gtype)
 {
+  ClutterPaintNodeClass *klass;
+
   g_return_val_if_fail (g_type_is_a (gtype, CLUTTER_TYPE_PAINT_NODE), NULL);
 
+  klass = g_type_class_peek (gtype);
+  if (klass && klass->free_nodes)
+    {
+      ClutterPaintNode *node = klass->free_nodes;
+
+      klass->free_nodes = node->next_sibling;
+      klass->n_free_nodes--;
+
+      /* Recyclable types have no instance initialization of their own, so
+       * this leaves the node as g_type_create_instance() would.
+       */
+      memset ((char *) node + sizeof (GTypeInstance), 0,
+              klass->instance_size - sizeof (GTypeInstance));
+      node->ref_count = 1;
+
+      return node;
+    }
+
   return (gpointer) g_type_create_instance (gtype);
 }
 
+/*< private >
+ * clutter_paint_node_class_set_recyclable:
+ * @klass: a #ClutterPaintNodeClass
+ *
+ * Lets freed instances of exactly the type of @klass be reused by
+ * _clutter_paint_node_create(), instead of going back to the allocator.
+ * Nodes of these types are created and destroyed for every painted actor
+ * on every frame.
+ *
+ * Must be called from the class_init function of types whose instances
+ * are fully initialized by being zero-filled, i.e. that have an empty
+ * instance_init function.
+ */
+void
+clutter_paint_node_class_set_recyclable (ClutterPaintNodeClass *klass)
+{
+  GTypeQuery query;
+
+  g_type_query (G_TYPE_FROM_CLASS (klass), &query);
+
+  klass->recyclable = TRUE;
+  klass->instance_size = query.instance_size;
+}
+
 static ClutterPaintNode *
 clutter_paint_node_get_root (ClutterPaintNode *node)
 {
@@ -152,6 +152,8 @@ clutter_root_node_class_init (ClutterRootNodeClass *klass)
   node_class->post_draw = clutter_root_node_post_draw;
   node_class->finalize = clutter_root_node_finalize;
   node_class->get_framebuffer = clutter_root_node_get_framebuffer;
+
+  clutter_paint_node_class_set_recyclable (node_class);
 }
 
 static void
@@ -233,12 +235,13 @@ clutter_transform_node_class_init (ClutterTransformNodeClass *klass)
   node_class = CLUTTER_PAINT_NODE_CLASS (klass);
   node_class->pre_draw = clutter_transform_node_pre_draw;
   node_class->post_draw = clutter_transform_node_post_draw;
+
+  clutter_paint_node_class_set_recyclable (node_class);
 }
 
 static void
 clutter_transform_node_init (ClutterTransformNode *self)
 {
-  cogl_matrix_init_identity (&self->transform);
 }
 
 /*
@@ -256,6 +259,8 @@ clutter_transform_node_new (const CoglMatrix *transform)
   res = _clutter_paint_node_create (CLUTTER_TYPE_TRANSFORM_NODE);
   if (transform)
     res->transform = *transform;
+  else
+    cogl_matrix_init_identity (&res->transform);
 
   return (ClutterPaintNode *) res;
 }
@@ -340,6 +345,8 @@ clutter_dummy_node_class_init (ClutterDummyNodeClass *klass)
   node_class->serialize = clutter_dummy_node_serialize;
   node_class->get_framebuffer = clutter_dummy_node_get_framebuffer;
   node_class->finalize = clutter_dummy_node_finalize;
+
+  clutter_paint_node_class_set_recyclable (node_class);
 }
 
 static void
@@ -543,6 +550,8 @@ clutter_pipeline_node_class_init (ClutterPipelineNodeClass *klass)
   node_class->post_draw = clutter_pipeline_node_post_draw;
   node_class->finalize = clutter_pipeline_node_finalize;
   node_class->serialize = clutter_pipeline_node_serialize;
+
+  clutter_paint_node_class_set_recyclable (node_class);
 }
 
 static void
@@ -1082,6 +1091,8 @@ clutter_clip_node_class_init (ClutterClipNodeClass *klass)
   node_class = CLUTTER_PAINT_NODE_CLASS (klass);
   node_class->pre_draw = clutter_clip_node_pre_draw;
   node_class->post_draw = clutter_clip_node_post_draw;
+
+  clutter_paint_node_class_set_recyclable (node_class);
 }
 
 static void
@@ -1182,6 +1193,8 @@ clutter_actor_node_class_init (ClutterActorNodeClass *klass)
   node_class->draw = clutter_actor_node_draw;
   node_class->post_draw = clutter_actor_node_post_draw;
   node_class->serialize = clutter_actor_node_serialize;
+
+  clutter_paint_node_class_set_recyclable (node_class);
 }
 
 static void
@@ -37,6 +37,7 @@
 #include "clutter-feature.h"
 #include "clutter-id-pool.h"
 #include "clutter-layout-manager.h"
+#include "clutter-offscreen-pool.h"
 #include "clutter-settings.h"
 #include "clutter-stage-manager.h"
 #include "clutter-stage.h"
@@ -155,6 +156,9 @@ struct _ClutterMainContext
   /* main settings singleton */
   ClutterSettings *settings;
 
+  /* offscreen render targets shared between effects */
+  ClutterOffscreenPool *offscreen_pool;
+
   /* boolean flags */
   guint is_initialized          : 1;
   guint defer_display_setup     : 1;
@@ -278,6 +282,11 @@ gboolean        _clutter_util_matrix_decompose  (const ClutterMatrix *src,
                                                  graphene_point3d_t  *translate_p,
                                                  ClutterVertex4      *perspective_p);
 
+void            _clutter_matrix_interpolate     (const ClutterMatrix *matrix1,
+                                                 const ClutterMatrix *matrix2,
+                                                 double               progress,
+                                                 ClutterMatrix       *res);
+
 CLUTTER_EXPORT
 PangoDirection _clutter_pango_unichar_direction (gunichar ch);
 
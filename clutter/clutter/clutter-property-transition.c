@@ -34,6 +34,7 @@
 
 #include "clutter-property-transition.h"
 
+#include "clutter-actor-private.h"
 #include "clutter-animatable.h"
 #include "clutter-debug.h"
 #include "clutter-interval.h"
@@ -144,6 +145,13 @@ clutter_property_transition_compute_value (ClutterTransition *transition,
 
   clutter_property_transition_ensure_interval (self, animatable, interval);
 
+  if (CLUTTER_IS_ACTOR (animatable) &&
+      _clutter_actor_interpolate_animatable_property (CLUTTER_ACTOR (animatable),
+                                                      priv->pspec,
+                                                      interval,
+                                                      progress))
+    return;
+
   p_type = G_PARAM_SPEC_VALUE_TYPE (priv->pspec);
   i_type = clutter_interval_get_value_type (interval);
 
@@ -157,7 +165,7 @@ clutter_property_transition_compute_value (ClutterTransition *transition,
 
   if (res)
     {
-      if (i_type != p_type || g_type_is_a (i_type, p_type))
+      if (i_type != p_type && !g_type_is_a (i_type, p_type))
         {
           if (g_value_type_transformable (i_type, p_type))
             {
@@ -24,6 +24,7 @@
 #include <math.h>
 
 #include "clutter/clutter-damage-history.h"
+#include "clutter/clutter-damage-tiles.h"
 #include "clutter/clutter-frame-clock.h"
 #include "clutter/clutter-private.h"
 #include "clutter/clutter-mutter.h"
@@ -469,26 +470,6 @@ clutter_stage_view_after_paint (ClutterStageView *view,
     }
 }
 
-static gboolean
-is_tile_dirty (cairo_rectangle_int_t *tile,
-               uint8_t               *current_data,
-               uint8_t               *prev_data,
-               int                    bpp,
-               int                    stride)
-{
-  int y;
-
-  for (y = tile->y; y < tile->y + tile->height; y++)
-    {
-      if (memcmp (prev_data + y * stride + tile->x * bpp,
-                  current_data + y * stride + tile->x * bpp,
-                  tile->width * bpp) != 0)
-        return TRUE;
-    }
-
-  return FALSE;
-}
-
 static int
 flip_dma_buf_idx (int idx)
 {
@@ -503,8 +484,6 @@ find_damaged_tiles (ClutterStageView      *view,
   ClutterStageViewPrivate *priv =
     clutter_stage_view_get_instance_private (view);
   cairo_region_t *tile_damage_region;
-  cairo_rectangle_int_t damage_extents;
-  cairo_rectangle_int_t fb_rect;
   int prev_dma_buf_idx;
   CoglDmaBufHandle *prev_dma_buf_handle;
   uint8_t *prev_data;
@@ -512,10 +491,6 @@ find_damaged_tiles (ClutterStageView      *view,
   CoglDmaBufHandle *current_dma_buf_handle;
   uint8_t *current_data;
   int width, height, stride, bpp;
-  int tile_x_min, tile_x_max;
-  int tile_y_min, tile_y_max;
-  int tile_x, tile_y;
-  const int tile_size = 16;
 
   prev_dma_buf_idx = flip_dma_buf_idx (priv->shadow.dma_buf.current_idx);
   prev_dma_buf_handle = priv->shadow.dma_buf.handles[prev_dma_buf_idx];
@@ -543,43 +518,11 @@ find_damaged_tiles (ClutterStageView      *view,
   if (!current_data)
     goto err_mmap_current;
 
-  fb_rect = (cairo_rectangle_int_t) {
-    .width = width,
-    .height = height,
-  };
-
-  cairo_region_get_extents (damage_region, &damage_extents);
-
-  tile_x_min = damage_extents.x / tile_size;
-  tile_x_max = ((damage_extents.x + damage_extents.width + tile_size - 1) /
-                tile_size);
-  tile_y_min = damage_extents.y / tile_size;
-  tile_y_max = ((damage_extents.y + damage_extents.height + tile_size - 1) /
-                tile_size);
-
-  tile_damage_region = cairo_region_create ();
-
-  for (tile_y = tile_y_min; tile_y <= tile_y_max; tile_y++)
-    {
-      for (tile_x = tile_x_min; tile_x <= tile_x_max; tile_x++)
-        {
-          cairo_rectangle_int_t tile = {
-            .x = tile_x * tile_size,
-            .y = tile_y * tile_size,
-            .width = tile_size,
-            .height = tile_size,
-          };
-
-          if (cairo_region_contains_rectangle (damage_region, &tile) ==
-              CAIRO_REGION_OVERLAP_OUT)
-            continue;
-
-          _clutter_util_rectangle_intersection (&tile, &fb_rect, &tile);
-
-          if (is_tile_dirty (&tile, current_data, prev_data, bpp, stride))
-            cairo_region_union_rectangle (tile_damage_region, &tile);
-        }
-    }
+  tile_damage_region = clutter_damage_tiles_find (damage_region,
+                                                  current_data,
+                                                  prev_data,
+                                                  width, height,
+                                                  stride, bpp);
 
   if (!cogl_dma_buf_handle_sync_read_end (prev_dma_buf_handle, error))
     {
@@ -598,8 +541,6 @@ find_damaged_tiles (ClutterStageView      *view,
   cogl_dma_buf_handle_munmap (prev_dma_buf_handle, prev_data, NULL);
   cogl_dma_buf_handle_munmap (current_dma_buf_handle, current_data, NULL);
 
-  cairo_region_intersect (tile_damage_region, damage_region);
-
   return tile_damage_region;
 
 err_mmap_current:
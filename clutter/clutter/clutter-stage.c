@@ -66,6 +66,7 @@
 #include "clutter-main.h"
 #include "clutter-marshal.h"
 #include "clutter-mutter.h"
+#include "clutter-offscreen-pool.h"
 #include "clutter-paint-context-private.h"
 #include "clutter-paint-volume-private.h"
 #include "clutter-pick-context-private.h"
@@ -130,6 +131,8 @@ struct _ClutterStagePrivate
   int pick_clip_stack_top;
   gboolean pick_stack_frozen;
   ClutterPickMode cached_pick_mode;
+  /* actors outside of the view are culled, see clutter_actor_pick() */
+  ClutterStageView *cached_pick_view;
 
 #ifdef CLUTTER_ENABLE_DEBUG
   gulong redraw_count;
@@ -1244,8 +1247,11 @@ clutter_stage_maybe_relayout (ClutterActor *actor)
 
       CLUTTER_SET_PRIVATE_FLAGS (queued_actor, CLUTTER_IN_RELAYOUT);
 
-      clutter_actor_get_fixed_position (queued_actor, &x, &y);
-      clutter_actor_allocate_preferred_size (queued_actor, x, y);
+      if (!_clutter_actor_allocate_relayout_boundary (queued_actor))
+        {
+          clutter_actor_get_fixed_position (queued_actor, &x, &y);
+          clutter_actor_allocate_preferred_size (queued_actor, x, y);
+        }
 
       CLUTTER_UNSET_PRIVATE_FLAGS (queued_actor, CLUTTER_IN_RELAYOUT);
 
@@ -1254,6 +1260,19 @@ clutter_stage_maybe_relayout (ClutterActor *actor)
 
   CLUTTER_NOTE (ACTOR, "<<< Completed recomputing layout of %d subtrees", count);
 
+#ifdef CLUTTER_ENABLE_DEBUG
+  if (CLUTTER_HAS_DEBUG (LAYOUT))
+    {
+      unsigned int hits, misses;
+
+      _clutter_actor_get_size_request_cache_stats (&hits, &misses);
+      CLUTTER_NOTE (LAYOUT, "Size request cache: %u hits, %u misses "
+                    "(%.1f%% hit rate)",
+                    hits, misses,
+                    hits + misses > 0 ? 100.0 * hits / (hits + misses) : 0.0);
+    }
+#endif
+
   if (count)
     priv->needs_update_devices = TRUE;
 }
@@ -1480,7 +1499,7 @@ _clutter_stage_do_pick_on_view (ClutterStage     *stage,
 
   g_assert (context->pick_mode == CLUTTER_PICK_NONE);
 
-  if (mode != priv->cached_pick_mode)
+  if (mode != priv->cached_pick_mode || view != priv->cached_pick_view)
     {
       ClutterPickContext *pick_context;
 
@@ -1493,6 +1512,7 @@ _clutter_stage_do_pick_on_view (ClutterStage     *stage,
       clutter_actor_pick (CLUTTER_ACTOR (stage), pick_context);
       context->pick_mode = CLUTTER_PICK_NONE;
       priv->cached_pick_mode = mode;
+      priv->cached_pick_view = view;
 
       clutter_pick_context_destroy (pick_context);
 
@@ -1978,6 +1998,18 @@ clutter_stage_notify_min_size (ClutterStage *self)
   self->priv->min_size_changed = TRUE;
 }
 
+static void
+clutter_stage_purge_offscreen_pool (ClutterStage *self)
+{
+  ClutterMainContext *context = _clutter_context_get_default ();
+
+  /* Run after the other handlers, so that offscreen effects have returned
+   * their render targets to the pool by the time it is purged.
+   */
+  if (context->offscreen_pool)
+    clutter_offscreen_pool_purge (context->offscreen_pool);
+}
+
 static void
 clutter_stage_init (ClutterStage *self)
 {
@@ -2035,6 +2067,9 @@ clutter_stage_init (ClutterStage *self)
                     G_CALLBACK (clutter_stage_notify_min_size), NULL);
   g_signal_connect (self, "notify::min-height",
                     G_CALLBACK (clutter_stage_notify_min_size), NULL);
+  g_signal_connect_after (self, "gl-video-memory-purged",
+                          G_CALLBACK (clutter_stage_purge_offscreen_pool),
+                          NULL);
 
   clutter_stage_set_viewport (self, geom.width, geom.height);
 
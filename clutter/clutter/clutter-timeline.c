@@ -1169,6 +1169,21 @@ emit_frame_signal (ClutterTimeline *timeline)
 
   CLUTTER_NOTE (SCHEDULER, "Emitting ::new-frame signal on timeline[%p]", timeline);
 
+  /* Most timelines driving transitions only have the class handler; skip
+   * the cost of a full signal emission for those.
+   */
+  if (!g_signal_has_handler_pending (timeline,
+                                     timeline_signals[NEW_FRAME], 0,
+                                     FALSE))
+    {
+      ClutterTimelineClass *klass = CLUTTER_TIMELINE_GET_CLASS (timeline);
+
+      if (klass->new_frame != NULL)
+        klass->new_frame (timeline, elapsed);
+
+      return;
+    }
+
   g_signal_emit (timeline, timeline_signals[NEW_FRAME], 0, elapsed);
 }
 
@@ -142,6 +142,8 @@ struct _MetaBackendPrivate
   MetaProfiler *profiler;
 #endif
 
+  MetaFrameStats *frame_stats;
+
 #ifdef HAVE_LIBWACOM
   WacomDeviceDatabase *wacom_db;
 #endif
@@ -232,6 +234,8 @@ meta_backend_finalize (GObject *object)
   g_clear_object (&priv->profiler);
 #endif
 
+  g_clear_object (&priv->frame_stats);
+
   G_OBJECT_CLASS (meta_backend_parent_class)->finalize (object);
 }
 
@@ -516,6 +520,8 @@ meta_backend_real_post_init (MetaBackend *backend)
   clutter_actor_realize (priv->stage);
   META_BACKEND_GET_CLASS (backend)->select_stage_events (backend);
 
+  priv->frame_stats = meta_frame_stats_new (backend);
+
   meta_monitor_manager_setup (priv->monitor_manager);
 
   meta_backend_sync_screen_size (backend);
@@ -1124,6 +1130,17 @@ meta_backend_get_settings (MetaBackend *backend)
   return priv->settings;
 }
 
+/**
+ * meta_backend_get_frame_stats: (skip)
+ */
+MetaFrameStats *
+meta_backend_get_frame_stats (MetaBackend *backend)
+{
+  MetaBackendPrivate *priv = meta_backend_get_instance_private (backend);
+
+  return priv->frame_stats;
+}
+
 #ifdef HAVE_REMOTE_DESKTOP
 /**
  * meta_backend_get_remote_desktop: (skip)
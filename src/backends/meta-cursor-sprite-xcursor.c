@@ -35,6 +35,7 @@ struct _MetaCursorSpriteXcursor
 
   int current_frame;
   XcursorImages *xcursor_images;
+  unsigned int images_serial;
 
   int theme_scale;
   gboolean theme_dirty;
@@ -246,6 +247,28 @@ meta_cursor_sprite_xcursor_get_current_image (MetaCursorSpriteXcursor *sprite_xc
   return sprite_xcursor->xcursor_images->images[sprite_xcursor->current_frame];
 }
 
+XcursorImages *
+meta_cursor_sprite_xcursor_get_images (MetaCursorSpriteXcursor *sprite_xcursor)
+{
+  return sprite_xcursor->xcursor_images;
+}
+
+int
+meta_cursor_sprite_xcursor_get_current_frame (MetaCursorSpriteXcursor *sprite_xcursor)
+{
+  return sprite_xcursor->current_frame;
+}
+
+/*
+ * The serial changes every time the images are reloaded from the theme, so
+ * that anything derived from the images can tell when it went stale.
+ */
+unsigned int
+meta_cursor_sprite_xcursor_get_images_serial (MetaCursorSpriteXcursor *sprite_xcursor)
+{
+  return sprite_xcursor->images_serial;
+}
+
 static void
 meta_cursor_sprite_xcursor_tick_frame (MetaCursorSprite *sprite)
 {
@@ -295,6 +318,7 @@ load_cursor_from_theme (MetaCursorSprite *sprite)
   sprite_xcursor->xcursor_images =
     load_cursor_on_client (sprite_xcursor->cursor,
                            sprite_xcursor->theme_scale);
+  sprite_xcursor->images_serial++;
   if (!sprite_xcursor->xcursor_images)
     g_error ("Could not find cursor. Perhaps set XCURSOR_PATH?");
 
@@ -37,6 +37,12 @@ MetaCursor meta_cursor_sprite_xcursor_get_cursor (MetaCursorSpriteXcursor *sprit
 
 XcursorImage * meta_cursor_sprite_xcursor_get_current_image (MetaCursorSpriteXcursor *sprite_xcursor);
 
+XcursorImages * meta_cursor_sprite_xcursor_get_images (MetaCursorSpriteXcursor *sprite_xcursor);
+
+int meta_cursor_sprite_xcursor_get_current_frame (MetaCursorSpriteXcursor *sprite_xcursor);
+
+unsigned int meta_cursor_sprite_xcursor_get_images_serial (MetaCursorSpriteXcursor *sprite_xcursor);
+
 Cursor meta_create_x_cursor (Display    *xdisplay,
                              MetaCursor  cursor);
 
@@ -0,0 +1,604 @@
+/* -*- mode: C; c-file-style: "gnu"; indent-tabs-mode: nil; -*- */
+
+/*
+ * Copyright (C) 2020 Endless Mobile, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * MetaFrameStats keeps lightweight histograms of frame timings per stage
+ * view, so that performance regressions can be spotted in regular sessions
+ * without having to attach a profiler. The statistics are exposed on the
+ * session bus as org.gnome.Mutter.FrameStats.
+ *
+ * Statistics are keyed by view name, so they survive the views being
+ * recreated on monitor configuration changes.
+ */
+
+#include "config.h"
+
+#include "backends/meta-frame-stats.h"
+
+#include <gio/gunixfdlist.h>
+#include <gio/gunixoutputstream.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "clutter/clutter-mutter.h"
+#include "meta/meta-backend.h"
+
+#define META_FRAME_STATS_DBUS_SERVICE "org.gnome.Mutter.FrameStats"
+#define META_FRAME_STATS_DBUS_PATH "/org/gnome/Mutter/FrameStats"
+
+#define N_BUCKETS 32
+
+/* Event timestamps older than this are considered bogus. */
+#define MAX_EVENT_AGE_MS 10000
+
+typedef enum _MetaFrameMetric
+{
+  META_FRAME_METRIC_DISPATCH,
+  META_FRAME_METRIC_PAINT,
+  META_FRAME_METRIC_PRESENT_LATENCY,
+  META_FRAME_METRIC_PRESENTATION_DELTA,
+  META_FRAME_METRIC_MISSED_VBLANKS,
+  META_FRAME_METRIC_INPUT_LATENCY,
+
+  N_FRAME_METRICS
+} MetaFrameMetric;
+
+static const char *metric_names[N_FRAME_METRICS] = {
+  [META_FRAME_METRIC_DISPATCH] = "dispatch",
+  [META_FRAME_METRIC_PAINT] = "paint",
+  [META_FRAME_METRIC_PRESENT_LATENCY] = "present-latency",
+  [META_FRAME_METRIC_PRESENTATION_DELTA] = "presentation-delta",
+  [META_FRAME_METRIC_MISSED_VBLANKS] = "missed-vblanks",
+  [META_FRAME_METRIC_INPUT_LATENCY] = "input-latency",
+};
+
+typedef struct _MetaFrameHistogram
+{
+  uint64_t count;
+  uint64_t sum;
+  uint64_t max;
+  uint64_t buckets[N_BUCKETS];
+} MetaFrameHistogram;
+
+typedef struct _MetaViewFrameStats
+{
+  MetaFrameHistogram histograms[N_FRAME_METRICS];
+
+  int64_t update_start_us;
+  int64_t paint_start_us;
+  int64_t paint_end_us;
+  int64_t last_presentation_time_us;
+
+  /* Earliest input event not yet handled by an update of this view. */
+  int64_t pending_input_time_us;
+  /* Earliest input event handled by the frame waiting to be presented. */
+  int64_t frame_input_time_us;
+} MetaViewFrameStats;
+
+struct _MetaFrameStats
+{
+  MetaDBusFrameStatsSkeleton parent;
+
+  MetaBackend *backend;
+
+  int dbus_name_id;
+  unsigned int event_filter_id;
+
+  GHashTable *view_stats;
+};
+
+static GQuark quark_view_frame_stats;
+
+static void
+meta_frame_stats_init_iface (MetaDBusFrameStatsIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (MetaFrameStats, meta_frame_stats,
+                         META_DBUS_TYPE_FRAME_STATS_SKELETON,
+                         G_IMPLEMENT_INTERFACE (META_DBUS_TYPE_FRAME_STATS,
+                                                meta_frame_stats_init_iface))
+
+static void
+histogram_add (MetaFrameHistogram *histogram,
+               uint64_t            value)
+{
+  unsigned int bucket;
+
+  if (value == 0)
+    bucket = 0;
+  else
+    bucket = MIN (g_bit_storage (MIN (value, G_MAXUINT32)), N_BUCKETS - 1);
+
+  histogram->count++;
+  histogram->sum += value;
+  histogram->max = MAX (histogram->max, value);
+  histogram->buckets[bucket]++;
+}
+
+static void
+record (MetaViewFrameStats *stats,
+        MetaFrameMetric     metric,
+        int64_t             value)
+{
+  histogram_add (&stats->histograms[metric], MAX (value, 0));
+}
+
+static MetaViewFrameStats *
+ensure_view_frame_stats (MetaFrameStats   *frame_stats,
+                         ClutterStageView *view)
+{
+  MetaViewFrameStats *stats;
+  g_autofree char *name = NULL;
+
+  stats = g_object_get_qdata (G_OBJECT (view), quark_view_frame_stats);
+  if (stats)
+    return stats;
+
+  g_object_get (view, "name", &name, NULL);
+  if (!name)
+    name = g_strdup ("stage");
+
+  stats = g_hash_table_lookup (frame_stats->view_stats, name);
+  if (!stats)
+    {
+      stats = g_new0 (MetaViewFrameStats, 1);
+      g_hash_table_insert (frame_stats->view_stats,
+                           g_steal_pointer (&name), stats);
+    }
+
+  g_object_set_qdata (G_OBJECT (view), quark_view_frame_stats, stats);
+
+  return stats;
+}
+
+static void
+on_before_update (ClutterStage     *stage,
+                  ClutterStageView *view,
+                  MetaFrameStats   *frame_stats)
+{
+  MetaViewFrameStats *stats = ensure_view_frame_stats (frame_stats, view);
+
+  stats->update_start_us = g_get_monotonic_time ();
+  stats->paint_start_us = 0;
+  stats->paint_end_us = 0;
+}
+
+static void
+on_before_paint (ClutterStage     *stage,
+                 ClutterStageView *view,
+                 MetaFrameStats   *frame_stats)
+{
+  MetaViewFrameStats *stats = ensure_view_frame_stats (frame_stats, view);
+
+  stats->paint_start_us = g_get_monotonic_time ();
+}
+
+static void
+on_after_paint (ClutterStage     *stage,
+                ClutterStageView *view,
+                MetaFrameStats   *frame_stats)
+{
+  MetaViewFrameStats *stats = ensure_view_frame_stats (frame_stats, view);
+
+  if (!stats->paint_start_us)
+    return;
+
+  stats->paint_end_us = g_get_monotonic_time ();
+  record (stats, META_FRAME_METRIC_PAINT,
+          stats->paint_end_us - stats->paint_start_us);
+
+  stats->frame_input_time_us = stats->pending_input_time_us;
+}
+
+static void
+on_after_update (ClutterStage     *stage,
+                 ClutterStageView *view,
+                 MetaFrameStats   *frame_stats)
+{
+  MetaViewFrameStats *stats = ensure_view_frame_stats (frame_stats, view);
+
+  if (!stats->update_start_us)
+    return;
+
+  record (stats, META_FRAME_METRIC_DISPATCH,
+          g_get_monotonic_time () - stats->update_start_us);
+
+  /*
+   * Input handled by an update that didn't paint this view didn't result in
+   * anything visible on it, so don't attribute it to a later frame.
+   */
+  stats->pending_input_time_us = 0;
+}
+
+static void
+on_presented (ClutterStage     *stage,
+              ClutterStageView *view,
+              ClutterFrameInfo *frame_info,
+              MetaFrameStats   *frame_stats)
+{
+  MetaViewFrameStats *stats = ensure_view_frame_stats (frame_stats, view);
+  int64_t presentation_time_us = frame_info->presentation_time;
+  int64_t refresh_interval_us;
+
+  /* Presentation times are not available on all backends. */
+  if (presentation_time_us <= 0 ||
+      !stats->paint_end_us ||
+      presentation_time_us < stats->paint_end_us)
+    {
+      stats->frame_input_time_us = 0;
+      return;
+    }
+
+  record (stats, META_FRAME_METRIC_PRESENT_LATENCY,
+          presentation_time_us - stats->paint_end_us);
+
+  if (stats->frame_input_time_us)
+    {
+      record (stats, META_FRAME_METRIC_INPUT_LATENCY,
+              presentation_time_us - stats->frame_input_time_us);
+      stats->frame_input_time_us = 0;
+    }
+
+  if (frame_info->refresh_rate > 0.0f)
+    {
+      refresh_interval_us = (int64_t) (G_USEC_PER_SEC /
+                                       frame_info->refresh_rate);
+
+      /*
+       * A frame is meant to be presented at the first vblank after its
+       * update started; anything after that is a missed vblank.
+       */
+      record (stats, META_FRAME_METRIC_MISSED_VBLANKS,
+              (presentation_time_us - stats->update_start_us) /
+              refresh_interval_us);
+
+      /*
+       * Only consider the time between presentations while continuously
+       * redrawing, otherwise idle periods would dominate the histogram.
+       */
+      if (stats->last_presentation_time_us &&
+          stats->update_start_us - stats->last_presentation_time_us <
+          refresh_interval_us)
+        {
+          record (stats, META_FRAME_METRIC_PRESENTATION_DELTA,
+                  presentation_time_us - stats->last_presentation_time_us);
+        }
+    }
+
+  stats->last_presentation_time_us = presentation_time_us;
+}
+
+static gboolean
+is_input_event (const ClutterEvent *event)
+{
+  switch (clutter_event_type (event))
+    {
+    case CLUTTER_KEY_PRESS:
+    case CLUTTER_KEY_RELEASE:
+    case CLUTTER_MOTION:
+    case CLUTTER_BUTTON_PRESS:
+    case CLUTTER_BUTTON_RELEASE:
+    case CLUTTER_SCROLL:
+    case CLUTTER_TOUCH_BEGIN:
+    case CLUTTER_TOUCH_UPDATE:
+    case CLUTTER_TOUCH_END:
+    case CLUTTER_TOUCHPAD_PINCH:
+    case CLUTTER_TOUCHPAD_SWIPE:
+      return TRUE;
+    default:
+      return FALSE;
+    }
+}
+
+static gboolean
+event_filter_func (const ClutterEvent *event,
+                   gpointer            user_data)
+{
+  MetaFrameStats *frame_stats = user_data;
+  GHashTableIter iter;
+  MetaViewFrameStats *stats;
+  int64_t now_us;
+  int64_t event_time_us;
+  uint32_t age_ms;
+
+  if (!is_input_event (event))
+    return CLUTTER_EVENT_PROPAGATE;
+
+  /*
+   * Event timestamps are in milliseconds of the monotonic clock, truncated
+   * to 32 bits; work out the age of the event from that.
+   */
+  now_us = g_get_monotonic_time ();
+  age_ms = (uint32_t) (now_us / 1000) - clutter_event_get_time (event);
+  if (age_ms > MAX_EVENT_AGE_MS)
+    event_time_us = now_us;
+  else
+    event_time_us = now_us - (int64_t) age_ms * 1000;
+
+  g_hash_table_iter_init (&iter, frame_stats->view_stats);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &stats))
+    {
+      if (!stats->pending_input_time_us)
+        stats->pending_input_time_us = event_time_us;
+    }
+
+  return CLUTTER_EVENT_PROPAGATE;
+}
+
+GVariant *
+meta_frame_stats_get_statistics (MetaFrameStats *frame_stats)
+{
+  GVariantBuilder views_builder;
+  GHashTableIter iter;
+  const char *name;
+  MetaViewFrameStats *stats;
+
+  g_variant_builder_init (&views_builder, G_VARIANT_TYPE ("a{sa{s(tttat)}}"));
+
+  g_hash_table_iter_init (&iter, frame_stats->view_stats);
+  while (g_hash_table_iter_next (&iter, (gpointer *) &name, (gpointer *) &stats))
+    {
+      GVariantBuilder metrics_builder;
+      int i;
+
+      g_variant_builder_init (&metrics_builder,
+                              G_VARIANT_TYPE ("a{s(tttat)}"));
+
+      for (i = 0; i < N_FRAME_METRICS; i++)
+        {
+          MetaFrameHistogram *histogram = &stats->histograms[i];
+          GVariant *buckets;
+
+          buckets = g_variant_new_fixed_array (G_VARIANT_TYPE_UINT64,
+                                               histogram->buckets,
+                                               N_BUCKETS,
+                                               sizeof (uint64_t));
+          g_variant_builder_add (&metrics_builder, "{s(ttt@at)}",
+                                 metric_names[i],
+                                 histogram->count,
+                                 histogram->sum,
+                                 histogram->max,
+                                 buckets);
+        }
+
+      g_variant_builder_add (&views_builder, "{sa{s(tttat)}}",
+                             name, &metrics_builder);
+    }
+
+  return g_variant_builder_end (&views_builder);
+}
+
+void
+meta_frame_stats_reset (MetaFrameStats *frame_stats)
+{
+  GHashTableIter iter;
+  MetaViewFrameStats *stats;
+
+  g_hash_table_iter_init (&iter, frame_stats->view_stats);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &stats))
+    memset (stats->histograms, 0, sizeof (stats->histograms));
+}
+
+gboolean
+meta_frame_stats_dump_to_fd (MetaFrameStats  *frame_stats,
+                             int              fd,
+                             GError         **error)
+{
+  g_autoptr (GVariant) statistics = NULL;
+  g_autoptr (GOutputStream) stream = NULL;
+  g_autofree char *contents = NULL;
+
+  statistics = g_variant_ref_sink (meta_frame_stats_get_statistics (frame_stats));
+  contents = g_variant_print (statistics, TRUE);
+
+  stream = g_unix_output_stream_new (fd, FALSE);
+
+  return g_output_stream_write_all (stream, contents, strlen (contents),
+                                    NULL, NULL, error);
+}
+
+static gboolean
+handle_get_statistics (MetaDBusFrameStats    *skeleton,
+                       GDBusMethodInvocation *invocation)
+{
+  MetaFrameStats *frame_stats = META_FRAME_STATS (skeleton);
+
+  meta_dbus_frame_stats_complete_get_statistics (
+    skeleton, invocation,
+    meta_frame_stats_get_statistics (frame_stats));
+
+  return TRUE;
+}
+
+static gboolean
+handle_reset (MetaDBusFrameStats    *skeleton,
+              GDBusMethodInvocation *invocation)
+{
+  MetaFrameStats *frame_stats = META_FRAME_STATS (skeleton);
+
+  meta_frame_stats_reset (frame_stats);
+  meta_dbus_frame_stats_complete_reset (skeleton, invocation);
+
+  return TRUE;
+}
+
+static gboolean
+handle_dump_to_file (MetaDBusFrameStats    *skeleton,
+                     GDBusMethodInvocation *invocation,
+                     GUnixFDList           *fd_list,
+                     GVariant              *fd_variant)
+{
+  MetaFrameStats *frame_stats = META_FRAME_STATS (skeleton);
+  g_autoptr (GError) error = NULL;
+  int position;
+  int fd = -1;
+
+  g_variant_get (fd_variant, "h", &position);
+
+  if (fd_list)
+    fd = g_unix_fd_list_get (fd_list, position, &error);
+
+  if (fd == -1)
+    {
+      g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
+                                             G_DBUS_ERROR_INVALID_ARGS,
+                                             "Invalid file descriptor");
+      return TRUE;
+    }
+
+  if (!meta_frame_stats_dump_to_fd (frame_stats, fd, &error))
+    {
+      close (fd);
+
+      g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
+                                             G_DBUS_ERROR_FAILED,
+                                             "Failed to write statistics: %s",
+                                             error->message);
+      return TRUE;
+    }
+
+  close (fd);
+
+  meta_dbus_frame_stats_complete_dump_to_file (skeleton, invocation, NULL);
+
+  return TRUE;
+}
+
+static void
+meta_frame_stats_init_iface (MetaDBusFrameStatsIface *iface)
+{
+  iface->handle_get_statistics = handle_get_statistics;
+  iface->handle_reset = handle_reset;
+  iface->handle_dump_to_file = handle_dump_to_file;
+}
+
+static void
+on_bus_acquired (GDBusConnection *connection,
+                 const char      *name,
+                 gpointer         user_data)
+{
+  MetaFrameStats *frame_stats = user_data;
+  GDBusInterfaceSkeleton *interface_skeleton =
+    G_DBUS_INTERFACE_SKELETON (frame_stats);
+  g_autoptr (GError) error = NULL;
+
+  if (!g_dbus_interface_skeleton_export (interface_skeleton,
+                                         connection,
+                                         META_FRAME_STATS_DBUS_PATH,
+                                         &error))
+    g_warning ("Failed to export frame stats object: %s", error->message);
+}
+
+static void
+on_name_acquired (GDBusConnection *connection,
+                  const char      *name,
+                  gpointer         user_data)
+{
+  g_info ("Acquired name %s", name);
+}
+
+static void
+on_name_lost (GDBusConnection *connection,
+              const char      *name,
+              gpointer         user_data)
+{
+  g_warning ("Lost or failed to acquire name %s", name);
+}
+
+MetaFrameStats *
+meta_frame_stats_new (MetaBackend *backend)
+{
+  MetaFrameStats *frame_stats;
+  ClutterActor *stage = meta_backend_get_stage (backend);
+
+  frame_stats = g_object_new (META_TYPE_FRAME_STATS, NULL);
+  frame_stats->backend = backend;
+
+  g_signal_connect_object (stage, "before-update",
+                           G_CALLBACK (on_before_update), frame_stats, 0);
+  g_signal_connect_object (stage, "before-paint",
+                           G_CALLBACK (on_before_paint), frame_stats, 0);
+  g_signal_connect_object (stage, "after-paint",
+                           G_CALLBACK (on_after_paint), frame_stats, 0);
+  g_signal_connect_object (stage, "after-update",
+                           G_CALLBACK (on_after_update), frame_stats, 0);
+  g_signal_connect_object (stage, "presented",
+                           G_CALLBACK (on_presented), frame_stats, 0);
+
+  frame_stats->event_filter_id =
+    clutter_event_add_filter (CLUTTER_STAGE (stage),
+                              event_filter_func,
+                              NULL,
+                              frame_stats);
+
+  frame_stats->dbus_name_id =
+    g_bus_own_name (G_BUS_TYPE_SESSION,
+                    META_FRAME_STATS_DBUS_SERVICE,
+                    G_BUS_NAME_OWNER_FLAGS_NONE,
+                    on_bus_acquired,
+                    on_name_acquired,
+                    on_name_lost,
+                    frame_stats,
+                    NULL);
+
+  return frame_stats;
+}
+
+static void
+meta_frame_stats_finalize (GObject *object)
+{
+  MetaFrameStats *frame_stats = META_FRAME_STATS (object);
+  ClutterActor *stage = meta_backend_get_stage (frame_stats->backend);
+  GList *l;
+
+  if (frame_stats->dbus_name_id)
+    g_bus_unown_name (frame_stats->dbus_name_id);
+
+  if (frame_stats->event_filter_id)
+    clutter_event_remove_filter (frame_stats->event_filter_id);
+
+  if (stage)
+    {
+      for (l = clutter_stage_peek_stage_views (CLUTTER_STAGE (stage));
+           l;
+           l = l->next)
+        g_object_set_qdata (G_OBJECT (l->data), quark_view_frame_stats, NULL);
+    }
+
+  g_clear_pointer (&frame_stats->view_stats, g_hash_table_unref);
+
+  G_OBJECT_CLASS (meta_frame_stats_parent_class)->finalize (object);
+}
+
+static void
+meta_frame_stats_init (MetaFrameStats *frame_stats)
+{
+  frame_stats->view_stats = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                   g_free, g_free);
+}
+
+static void
+meta_frame_stats_class_init (MetaFrameStatsClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = meta_frame_stats_finalize;
+
+  quark_view_frame_stats =
+    g_quark_from_static_string ("-meta-view-frame-stats");
+}
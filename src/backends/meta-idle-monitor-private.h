@@ -34,8 +34,8 @@ typedef struct
   gpointer		    user_data;
   GDestroyNotify            notify;
   guint64                   timeout_msec;
-  int                       idle_source_id;
-  GSource                  *timeout_source;
+  GList                    *link;
+  guint64                   fired_activity_serial;
 } MetaIdleMonitorWatch;
 
 struct _MetaIdleMonitor
@@ -47,6 +47,12 @@ struct _MetaIdleMonitor
   GHashTable *watches;
   ClutterInputDevice *device;
   guint64 last_event_time;
+
+  /* Idle watches sorted by timeout, sharing a single timeout source. */
+  GQueue idle_watches;
+  GQueue user_active_watches;
+  GSource *timeout_source;
+  guint64 activity_serial;
 };
 
 struct _MetaIdleMonitorClass
@@ -64,10 +64,9 @@ meta_idle_monitor_watch_fire (MetaIdleMonitorWatch *watch)
   monitor = watch->monitor;
   g_object_ref (monitor);
 
-  g_clear_handle_id (&watch->idle_source_id, g_source_remove);
-
   id = watch->id;
   is_user_active_watch = (watch->timeout_msec == 0);
+  watch->fired_activity_serial = monitor->activity_serial;
 
   if (watch->callback)
     watch->callback (monitor, id, watch->user_data);
@@ -86,6 +85,12 @@ meta_idle_monitor_dispose (GObject *object)
   g_clear_pointer (&monitor->watches, g_hash_table_destroy);
   g_clear_object (&monitor->session_proxy);
 
+  if (monitor->timeout_source)
+    {
+      g_source_destroy (monitor->timeout_source);
+      g_clear_pointer (&monitor->timeout_source, g_source_unref);
+    }
+
   G_OBJECT_CLASS (meta_idle_monitor_parent_class)->dispose (object);
 }
 
@@ -158,39 +163,47 @@ free_watch (gpointer data)
 
   g_object_ref (monitor);
 
-  g_clear_handle_id (&watch->idle_source_id, g_source_remove);
+  if (watch->timeout_msec == 0)
+    g_queue_delete_link (&monitor->user_active_watches, watch->link);
+  else
+    g_queue_delete_link (&monitor->idle_watches, watch->link);
 
   if (watch->notify != NULL)
     watch->notify (watch->user_data);
 
-  if (watch->timeout_source != NULL)
-    g_source_destroy (watch->timeout_source);
-
   g_object_unref (monitor);
   g_slice_free (MetaIdleMonitorWatch, watch);
 }
 
+/*
+ * Sets the timeout source to dispatch when the first idle watch that
+ * hasn't fired since the last activity expires.
+ */
 static void
-update_inhibited_watch (gpointer key,
-                        gpointer value,
-                        gpointer user_data)
+update_timeout (MetaIdleMonitor *monitor)
 {
-  MetaIdleMonitor *monitor = user_data;
-  MetaIdleMonitorWatch *watch = value;
+  GList *l;
 
-  if (!watch->timeout_source)
+  if (!monitor->timeout_source)
     return;
 
-  if (monitor->inhibited)
+  if (!monitor->inhibited)
     {
-      g_source_set_ready_time (watch->timeout_source, -1);
-    }
-  else
-    {
-      g_source_set_ready_time (watch->timeout_source,
-                               monitor->last_event_time +
-                               watch->timeout_msec * 1000);
+      for (l = monitor->idle_watches.head; l; l = l->next)
+        {
+          MetaIdleMonitorWatch *watch = l->data;
+
+          if (watch->fired_activity_serial == monitor->activity_serial)
+            continue;
+
+          g_source_set_ready_time (monitor->timeout_source,
+                                   monitor->last_event_time +
+                                   watch->timeout_msec * 1000);
+          return;
+        }
     }
+
+  g_source_set_ready_time (monitor->timeout_source, -1);
 }
 
 static void
@@ -202,9 +215,16 @@ update_inhibited (MetaIdleMonitor *monitor,
 
   monitor->inhibited = inhibited;
 
-  g_hash_table_foreach (monitor->watches,
-                        update_inhibited_watch,
-                        monitor);
+  /* Idle time counts from the end of the inhibition, and watches that
+   * fired before it may fire again.
+   */
+  if (!inhibited)
+    {
+      monitor->last_event_time = g_get_monotonic_time ();
+      monitor->activity_serial++;
+    }
+
+  update_timeout (monitor);
 }
 
 static void
@@ -224,8 +244,6 @@ meta_idle_monitor_inhibited_actions_changed (GDBusProxy  *session,
       inhibited = !!(g_variant_get_uint32 (v) & GSM_INHIBITOR_FLAG_IDLE);
       g_variant_unref (v);
 
-      if (!inhibited)
-        monitor->last_event_time = g_get_monotonic_time ();
       update_inhibited (monitor, inhibited);
     }
 }
@@ -292,12 +310,39 @@ get_next_watch_serial (void)
   return serial;
 }
 
+static void
+fire_expired_watches (MetaIdleMonitor *monitor,
+                      int64_t          now)
+{
+  GList *l;
+
+restart:
+  for (l = monitor->idle_watches.head; l; l = l->next)
+    {
+      MetaIdleMonitorWatch *watch = l->data;
+
+      if (monitor->inhibited)
+        return;
+
+      if (monitor->last_event_time + watch->timeout_msec * 1000 > (guint64) now)
+        return;
+
+      if (watch->fired_activity_serial == monitor->activity_serial)
+        continue;
+
+      meta_idle_monitor_watch_fire (watch);
+
+      /* The callback might have added or removed watches. */
+      goto restart;
+    }
+}
+
 static gboolean
 idle_monitor_dispatch_timeout (GSource     *source,
                                GSourceFunc  callback,
                                gpointer     user_data)
 {
-  MetaIdleMonitorWatch *watch = (MetaIdleMonitorWatch *) user_data;
+  MetaIdleMonitor *monitor = user_data;
   int64_t now;
   int64_t ready_time;
 
@@ -306,9 +351,14 @@ idle_monitor_dispatch_timeout (GSource     *source,
   if (ready_time > now)
     return G_SOURCE_CONTINUE;
 
-  g_source_set_ready_time (watch->timeout_source, -1);
+  g_object_ref (monitor);
 
-  meta_idle_monitor_watch_fire (watch);
+  fire_expired_watches (monitor, now);
+
+  if (monitor->timeout_source)
+    update_timeout (monitor);
+
+  g_object_unref (monitor);
 
   return G_SOURCE_CONTINUE;
 }
@@ -337,23 +387,47 @@ make_watch (MetaIdleMonitor           *monitor,
   watch->user_data = user_data;
   watch->notify = notify;
   watch->timeout_msec = timeout_msec;
+  watch->fired_activity_serial = monitor->activity_serial - 1;
 
   if (timeout_msec != 0)
     {
-      GSource *source = g_source_new (&idle_monitor_source_funcs,
-                                      sizeof (GSource));
+      GList *sibling;
+      int64_t ready_time;
+      int64_t current_ready_time;
 
-      g_source_set_callback (source, NULL, watch, NULL);
-      if (!monitor->inhibited)
+      for (sibling = monitor->idle_watches.head; sibling; sibling = sibling->next)
         {
-          g_source_set_ready_time (source,
-                                   monitor->last_event_time +
-                                   timeout_msec * 1000);
+          MetaIdleMonitorWatch *other_watch = sibling->data;
+
+          if (other_watch->timeout_msec > timeout_msec)
+            break;
         }
-      g_source_attach (source, NULL);
-      g_source_unref (source);
 
-      watch->timeout_source = source;
+      g_queue_insert_before (&monitor->idle_watches, sibling, watch);
+      watch->link = sibling ? sibling->prev : monitor->idle_watches.tail;
+
+      if (!monitor->timeout_source)
+        {
+          GSource *source = g_source_new (&idle_monitor_source_funcs,
+                                          sizeof (GSource));
+
+          g_source_set_callback (source, NULL, monitor, NULL);
+          g_source_set_ready_time (source, -1);
+          g_source_attach (source, NULL);
+
+          monitor->timeout_source = source;
+        }
+
+      ready_time = monitor->last_event_time + timeout_msec * 1000;
+      current_ready_time = g_source_get_ready_time (monitor->timeout_source);
+      if (!monitor->inhibited &&
+          (current_ready_time == -1 || ready_time < current_ready_time))
+        g_source_set_ready_time (monitor->timeout_source, ready_time);
+    }
+  else
+    {
+      g_queue_push_tail (&monitor->user_active_watches, watch);
+      watch->link = monitor->user_active_watches.tail;
     }
 
   g_hash_table_insert (monitor->watches,
@@ -473,43 +547,58 @@ meta_idle_monitor_get_idletime (MetaIdleMonitor *monitor)
   return (g_get_monotonic_time () - monitor->last_event_time) / 1000;
 }
 
+/*
+ * Resetting the idle time doesn't touch the idle watches; they are all
+ * considered not fired by bumping the activity serial, and the shared
+ * timeout is only moved if it would otherwise dispatch too late. A timeout
+ * dispatching too early just reschedules itself.
+ */
 void
 meta_idle_monitor_reset_idletime (MetaIdleMonitor *monitor)
 {
-  GList *node, *watch_ids;
+  gboolean had_fired_watches = FALSE;
 
   monitor->last_event_time = g_get_monotonic_time ();
 
-  watch_ids = g_hash_table_get_keys (monitor->watches);
-
-  for (node = watch_ids; node != NULL; node = node->next)
+  if (monitor->idle_watches.head)
     {
-      guint watch_id = GPOINTER_TO_UINT (node->data);
-      MetaIdleMonitorWatch *watch;
+      MetaIdleMonitorWatch *first_watch = monitor->idle_watches.head->data;
 
-      watch = g_hash_table_lookup (monitor->watches,
-                                   GUINT_TO_POINTER (watch_id));
-      if (!watch)
-        continue;
+      had_fired_watches =
+        first_watch->fired_activity_serial == monitor->activity_serial;
+    }
+
+  monitor->activity_serial++;
+
+  if (monitor->timeout_source && !monitor->inhibited &&
+      (had_fired_watches ||
+       g_source_get_ready_time (monitor->timeout_source) == -1))
+    update_timeout (monitor);
+
+  if (monitor->user_active_watches.head)
+    {
+      GList *node, *watch_ids = NULL;
 
-      if (watch->timeout_msec == 0)
+      for (node = monitor->user_active_watches.head; node; node = node->next)
         {
-          meta_idle_monitor_watch_fire (watch);
+          MetaIdleMonitorWatch *watch = node->data;
+
+          watch_ids = g_list_prepend (watch_ids, GUINT_TO_POINTER (watch->id));
         }
-      else
+
+      for (node = watch_ids; node != NULL; node = node->next)
         {
-          if (monitor->inhibited)
-            {
-              g_source_set_ready_time (watch->timeout_source, -1);
-            }
-          else
-            {
-              g_source_set_ready_time (watch->timeout_source,
-                                       monitor->last_event_time +
-                                       watch->timeout_msec * 1000);
-            }
+          guint watch_id = GPOINTER_TO_UINT (node->data);
+          MetaIdleMonitorWatch *watch;
+
+          watch = g_hash_table_lookup (monitor->watches,
+                                       GUINT_TO_POINTER (watch_id));
+          if (!watch)
+            continue;
+
+          meta_idle_monitor_watch_fire (watch);
         }
-    }
 
-  g_list_free (watch_ids);
+      g_list_free (watch_ids);
+    }
 }
@@ -115,6 +115,8 @@ struct _MetaMonitorConfigStore
 
   GHashTable *configs;
 
+  GThread *load_thread;
+
   GCancellable *save_cancellable;
 
   GFile *user_file;
@@ -1082,19 +1084,15 @@ static const GMarkupParser config_parser = {
 };
 
 static gboolean
-read_config_file (MetaMonitorConfigStore  *config_store,
-                  GFile                   *file,
-                  MetaMonitorsConfigFlag   extra_config_flags,
-                  GError                 **error)
+parse_config_data (MetaMonitorConfigStore  *config_store,
+                   const char              *buffer,
+                   gsize                    size,
+                   MetaMonitorsConfigFlag   extra_config_flags,
+                   GError                 **error)
 {
-  char *buffer;
-  gsize size;
   ConfigParser parser;
   GMarkupParseContext *parse_context;
 
-  if (!g_file_load_contents (file, NULL, &buffer, &size, NULL, error))
-    return FALSE;
-
   parser = (ConfigParser) {
     .state = STATE_INITIAL,
     .config_store = config_store,
@@ -1116,19 +1114,185 @@ read_config_file (MetaMonitorConfigStore  *config_store,
                       meta_monitor_config_free);
       g_clear_pointer (&parser.current_logical_monitor_config,
                        meta_logical_monitor_config_free);
+      g_markup_parse_context_free (parse_context);
       return FALSE;
     }
 
   g_markup_parse_context_free (parse_context);
-  g_free (buffer);
 
   return TRUE;
 }
 
+static gboolean
+read_config_file (MetaMonitorConfigStore  *config_store,
+                  GFile                   *file,
+                  MetaMonitorsConfigFlag   extra_config_flags,
+                  GError                 **error)
+{
+  g_autofree char *buffer = NULL;
+  gsize size;
+
+  if (!g_file_load_contents (file, NULL, &buffer, &size, NULL, error))
+    return FALSE;
+
+  return parse_config_data (config_store, buffer, size,
+                            extra_config_flags, error);
+}
+
+typedef struct _ConfigFileLoad
+{
+  GFile *file;
+  MetaMonitorsConfigFlag flags;
+
+  char *buffer;
+  gsize size;
+  GError *error;
+} ConfigFileLoad;
+
+static void
+config_file_load_free (ConfigFileLoad *load)
+{
+  g_object_unref (load->file);
+  g_free (load->buffer);
+  g_clear_error (&load->error);
+  g_free (load);
+}
+
+static gpointer
+load_config_files_thread_func (gpointer user_data)
+{
+  GList *loads = user_data;
+  GList *l;
+
+  for (l = loads; l; l = l->next)
+    {
+      ConfigFileLoad *load = l->data;
+
+      g_file_load_contents (load->file, NULL,
+                            &load->buffer, &load->size,
+                            NULL, &load->error);
+    }
+
+  return loads;
+}
+
+static void
+handle_system_config_file (MetaMonitorConfigStore *config_store,
+                           ConfigFileLoad         *load)
+{
+  g_autofree char *system_file_path = NULL;
+  g_autoptr (GError) error = NULL;
+
+  if (g_error_matches (load->error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
+    return;
+
+  system_file_path = g_file_get_path (load->file);
+
+  if (load->error)
+    {
+      g_warning ("Failed to read monitors config file '%s': %s",
+                 system_file_path, load->error->message);
+      return;
+    }
+
+  if (!parse_config_data (config_store,
+                          load->buffer, load->size,
+                          META_MONITORS_CONFIG_FLAG_SYSTEM_CONFIG,
+                          &error))
+    {
+      if (g_error_matches (error,
+                           META_MONITOR_CONFIG_STORE_ERROR,
+                           META_MONITOR_CONFIG_STORE_ERROR_NEEDS_MIGRATION))
+        g_warning ("System monitor configuration file (%s) is "
+                   "incompatible; ask your administrator to migrate "
+                   "the system monitor configuration.",
+                   system_file_path);
+      else
+        g_warning ("Failed to read monitors config file '%s': %s",
+                   system_file_path, error->message);
+    }
+}
+
+static void
+handle_user_config_file (MetaMonitorConfigStore *config_store,
+                         ConfigFileLoad         *load)
+{
+  g_autofree char *user_file_path = NULL;
+  GError *error = NULL;
+
+  if (g_error_matches (load->error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
+    return;
+
+  user_file_path = g_file_get_path (load->file);
+
+  if (load->error)
+    {
+      g_warning ("Failed to read monitors config file '%s': %s",
+                 user_file_path, load->error->message);
+      return;
+    }
+
+  if (!parse_config_data (config_store,
+                          load->buffer, load->size,
+                          META_MONITORS_CONFIG_FLAG_NONE,
+                          &error))
+    {
+      if (error->domain == META_MONITOR_CONFIG_STORE_ERROR &&
+          error->code == META_MONITOR_CONFIG_STORE_ERROR_NEEDS_MIGRATION)
+        {
+          g_clear_error (&error);
+          if (!meta_migrate_old_user_monitors_config (config_store, &error))
+            {
+              g_warning ("Failed to migrate old monitors config file: %s",
+                         error->message);
+              g_error_free (error);
+            }
+        }
+      else
+        {
+          g_warning ("Failed to read monitors config file '%s': %s",
+                     user_file_path, error->message);
+          g_error_free (error);
+        }
+    }
+}
+
+/*
+ * The configuration files are read in a thread started when the store is
+ * constructed, so that slow file systems don't stall the rest of the
+ * backend initialization. The first time the stored configurations are
+ * needed, wait for the files to have been read and parse them.
+ */
+static void
+ensure_loaded (MetaMonitorConfigStore *config_store)
+{
+  GList *loads;
+  GList *l;
+
+  if (!config_store->load_thread)
+    return;
+
+  loads = g_thread_join (g_steal_pointer (&config_store->load_thread));
+
+  for (l = loads; l; l = l->next)
+    {
+      ConfigFileLoad *load = l->data;
+
+      if (load->flags & META_MONITORS_CONFIG_FLAG_SYSTEM_CONFIG)
+        handle_system_config_file (config_store, load);
+      else
+        handle_user_config_file (config_store, load);
+    }
+
+  g_list_free_full (loads, (GDestroyNotify) config_file_load_free);
+}
+
 MetaMonitorsConfig *
 meta_monitor_config_store_lookup (MetaMonitorConfigStore *config_store,
                                   MetaMonitorsConfigKey  *key)
 {
+  ensure_loaded (config_store);
+
   return META_MONITORS_CONFIG (g_hash_table_lookup (config_store->configs,
                                                     key));
 }
@@ -1444,6 +1608,8 @@ void
 meta_monitor_config_store_add (MetaMonitorConfigStore *config_store,
                                MetaMonitorsConfig     *config)
 {
+  ensure_loaded (config_store);
+
   g_hash_table_replace (config_store->configs,
                         config->key, g_object_ref (config));
 
@@ -1455,6 +1621,8 @@ void
 meta_monitor_config_store_remove (MetaMonitorConfigStore *config_store,
                                   MetaMonitorsConfig     *config)
 {
+  ensure_loaded (config_store);
+
   g_hash_table_remove (config_store->configs, config->key);
 
   if (!is_system_config (config))
@@ -1467,6 +1635,8 @@ meta_monitor_config_store_set_custom (MetaMonitorConfigStore *config_store,
                                       const char             *write_path,
                                       GError                **error)
 {
+  ensure_loaded (config_store);
+
   g_clear_object (&config_store->custom_read_file);
   g_clear_object (&config_store->custom_write_file);
   g_hash_table_remove_all (config_store->configs);
@@ -1484,6 +1654,8 @@ meta_monitor_config_store_set_custom (MetaMonitorConfigStore *config_store,
 int
 meta_monitor_config_store_get_config_count (MetaMonitorConfigStore *config_store)
 {
+  ensure_loaded (config_store);
+
   return (int) g_hash_table_size (config_store->configs);
 }
 
@@ -1501,79 +1673,52 @@ meta_monitor_config_store_new (MetaMonitorManager *monitor_manager)
                        NULL);
 }
 
+static ConfigFileLoad *
+config_file_load_new (GFile                  *file,
+                      MetaMonitorsConfigFlag  flags)
+{
+  ConfigFileLoad *load;
+
+  load = g_new0 (ConfigFileLoad, 1);
+  load->file = g_object_ref (file);
+  load->flags = flags;
+
+  return load;
+}
+
 static void
 meta_monitor_config_store_constructed (GObject *object)
 {
   MetaMonitorConfigStore *config_store = META_MONITOR_CONFIG_STORE (object);
   const char * const *system_dirs;
-  char *user_file_path;
-  GError *error = NULL;
+  g_autofree char *user_file_path = NULL;
+  GList *loads = NULL;
 
   for (system_dirs = g_get_system_config_dirs ();
        system_dirs && *system_dirs;
        system_dirs++)
     {
       g_autofree char *system_file_path = NULL;
+      g_autoptr (GFile) system_file = NULL;
 
       system_file_path = g_build_filename (*system_dirs, "monitors.xml", NULL);
-      if (g_file_test (system_file_path, G_FILE_TEST_EXISTS))
-        {
-          g_autoptr (GFile) system_file = NULL;
-
-          system_file = g_file_new_for_path (system_file_path);
-          if (!read_config_file (config_store,
-                                 system_file,
-                                 META_MONITORS_CONFIG_FLAG_SYSTEM_CONFIG,
-                                 &error))
-            {
-              if (g_error_matches (error,
-                                   META_MONITOR_CONFIG_STORE_ERROR,
-                                   META_MONITOR_CONFIG_STORE_ERROR_NEEDS_MIGRATION))
-                g_warning ("System monitor configuration file (%s) is "
-                           "incompatible; ask your administrator to migrate "
-                           "the system monitor configuration.",
-                           system_file_path);
-              else
-                g_warning ("Failed to read monitors config file '%s': %s",
-                           system_file_path, error->message);
-              g_clear_error (&error);
-            }
-        }
+      system_file = g_file_new_for_path (system_file_path);
+      loads = g_list_append (loads,
+                             config_file_load_new (system_file,
+                                                   META_MONITORS_CONFIG_FLAG_SYSTEM_CONFIG));
     }
 
   user_file_path = g_build_filename (g_get_user_config_dir (),
                                      "monitors.xml",
                                      NULL);
   config_store->user_file = g_file_new_for_path (user_file_path);
+  loads = g_list_append (loads,
+                         config_file_load_new (config_store->user_file,
+                                               META_MONITORS_CONFIG_FLAG_NONE));
 
-  if (g_file_test (user_file_path, G_FILE_TEST_EXISTS))
-    {
-      if (!read_config_file (config_store,
-                             config_store->user_file,
-                             META_MONITORS_CONFIG_FLAG_NONE,
-                             &error))
-        {
-          if (error->domain == META_MONITOR_CONFIG_STORE_ERROR &&
-              error->code == META_MONITOR_CONFIG_STORE_ERROR_NEEDS_MIGRATION)
-            {
-              g_clear_error (&error);
-              if (!meta_migrate_old_user_monitors_config (config_store, &error))
-                {
-                  g_warning ("Failed to migrate old monitors config file: %s",
-                             error->message);
-                  g_error_free (error);
-                }
-            }
-          else
-            {
-              g_warning ("Failed to read monitors config file '%s': %s",
-                         user_file_path, error->message);
-              g_error_free (error);
-            }
-        }
-    }
-
-  g_free (user_file_path);
+  config_store->load_thread = g_thread_new ("Monitor config loader",
+                                            load_config_files_thread_func,
+                                            loads);
 
   G_OBJECT_CLASS (meta_monitor_config_store_parent_class)->constructed (object);
 }
@@ -1583,6 +1728,14 @@ meta_monitor_config_store_dispose (GObject *object)
 {
   MetaMonitorConfigStore *config_store = META_MONITOR_CONFIG_STORE (object);
 
+  if (config_store->load_thread)
+    {
+      GList *loads;
+
+      loads = g_thread_join (g_steal_pointer (&config_store->load_thread));
+      g_list_free_full (loads, (GDestroyNotify) config_file_load_free);
+    }
+
   if (config_store->save_cancellable)
     {
       g_cancellable_cancel (config_store->save_cancellable);
@@ -38,6 +38,13 @@
 #define MINIMUM_LOGICAL_AREA (800 * 480)
 #define MAXIMUM_REFRESH_RATE_DIFF 0.001
 
+/*
+ * The supported scales only depend on the mode resolution and the scale
+ * constraints, and many modes share a resolution, so they are calculated
+ * once and kept around. Keys are packed by supported_scales_key().
+ */
+static GHashTable *supported_scales_cache;
+
 typedef struct _MetaMonitorMode
 {
   MetaMonitor *monitor;
@@ -59,7 +66,7 @@ typedef struct _MetaMonitorPrivate
   MetaGpu *gpu;
 
   GList *outputs;
-  GList *modes;
+  GQueue modes;
   GHashTable *mode_ids;
 
   MetaMonitorMode *preferred_mode;
@@ -501,7 +508,7 @@ meta_monitor_finalize (GObject *object)
   MetaMonitorPrivate *priv = meta_monitor_get_instance_private (monitor);
 
   g_hash_table_destroy (priv->mode_ids);
-  g_list_free_full (priv->modes, (GDestroyNotify) meta_monitor_mode_free);
+  g_queue_clear_full (&priv->modes, (GDestroyNotify) meta_monitor_mode_free);
   meta_monitor_spec_free (priv->spec);
   g_free (priv->display_name);
 
@@ -513,6 +520,7 @@ meta_monitor_init (MetaMonitor *monitor)
 {
   MetaMonitorPrivate *priv = meta_monitor_get_instance_private (monitor);
 
+  g_queue_init (&priv->modes);
   priv->mode_ids = g_hash_table_new (g_str_hash, g_str_equal);
 }
 
@@ -556,9 +564,9 @@ meta_monitor_add_mode (MetaMonitor     *monitor,
     return FALSE;
 
   if (existing_mode)
-    priv->modes = g_list_remove (priv->modes, existing_mode);
+    g_queue_remove (&priv->modes, existing_mode);
 
-  priv->modes = g_list_append (priv->modes, monitor_mode);
+  g_queue_push_tail (&priv->modes, monitor_mode);
   g_hash_table_replace (priv->mode_ids, monitor_mode->id, monitor_mode);
 
   return TRUE;
@@ -1260,7 +1268,7 @@ find_best_mode (MetaMonitor *monitor)
   MetaMonitorMode *best_mode = NULL;
   GList *l;
 
-  for (l = monitor_priv->modes; l; l = l->next)
+  for (l = monitor_priv->modes.head; l; l = l->next)
     {
       MetaMonitorMode *mode = l->data;
       int area, best_area;
@@ -1547,7 +1555,7 @@ meta_monitor_get_mode_from_spec (MetaMonitor         *monitor,
   MetaMonitorPrivate *priv = meta_monitor_get_instance_private (monitor);
   GList *l;
 
-  for (l = priv->modes; l; l = l->next)
+  for (l = priv->modes.head; l; l = l->next)
     {
       MetaMonitorMode *monitor_mode = l->data;
 
@@ -1595,7 +1603,7 @@ meta_monitor_derive_current_mode (MetaMonitor *monitor)
   MetaMonitorMode *current_mode = NULL;
   GList *l;
 
-  for (l = priv->modes; l; l = l->next)
+  for (l = priv->modes.head; l; l = l->next)
     {
       MetaMonitorMode *mode = l->data;
 
@@ -1625,7 +1633,7 @@ meta_monitor_get_modes (MetaMonitor *monitor)
 {
   MetaMonitorPrivate *priv = meta_monitor_get_instance_private (monitor);
 
-  return priv->modes;
+  return priv->modes.head;
 }
 
 void
@@ -1816,20 +1824,16 @@ out:
   return best_scale;
 }
 
-float *
-meta_monitor_calculate_supported_scales (MetaMonitor                 *monitor,
-                                         MetaMonitorMode             *monitor_mode,
-                                         MetaMonitorScalesConstraint  constraints,
-                                         int                         *n_supported_scales)
+static GArray *
+calculate_supported_scales (int                         width,
+                            int                         height,
+                            MetaMonitorScalesConstraint constraints)
 {
   unsigned int i, j;
-  int width, height;
   GArray *supported_scales;
 
   supported_scales = g_array_new (FALSE, FALSE, sizeof (float));
 
-  meta_monitor_mode_get_resolution (monitor_mode, &width, &height);
-
   for (i = floorf (MINIMUM_SCALE_FACTOR);
        i <= ceilf (MAXIMUM_SCALE_FACTOR);
        i++)
@@ -1862,8 +1866,52 @@ meta_monitor_calculate_supported_scales (MetaMonitor                 *monitor,
       g_array_append_val (supported_scales, fallback_scale);
     }
 
+  return supported_scales;
+}
+
+static uint64_t
+supported_scales_key (int                         width,
+                      int                         height,
+                      MetaMonitorScalesConstraint constraints)
+{
+  return (((uint64_t) constraints << 48) |
+          ((uint64_t) (width & 0xffffff) << 24) |
+          (uint64_t) (height & 0xffffff));
+}
+
+float *
+meta_monitor_calculate_supported_scales (MetaMonitor                 *monitor,
+                                         MetaMonitorMode             *monitor_mode,
+                                         MetaMonitorScalesConstraint  constraints,
+                                         int                         *n_supported_scales)
+{
+  int width, height;
+  uint64_t key;
+  GArray *supported_scales;
+
+  meta_monitor_mode_get_resolution (monitor_mode, &width, &height);
+
+  if (!supported_scales_cache)
+    {
+      supported_scales_cache =
+        g_hash_table_new_full (g_int64_hash, g_int64_equal,
+                               g_free, (GDestroyNotify) g_array_unref);
+    }
+
+  key = supported_scales_key (width, height, constraints);
+  supported_scales = g_hash_table_lookup (supported_scales_cache, &key);
+  if (!supported_scales)
+    {
+      supported_scales = calculate_supported_scales (width, height,
+                                                     constraints);
+      g_hash_table_insert (supported_scales_cache,
+                           g_memdup (&key, sizeof (key)),
+                           supported_scales);
+    }
+
   *n_supported_scales = supported_scales->len;
-  return (float *) g_array_free (supported_scales, FALSE);
+  return g_memdup (supported_scales->data,
+                   supported_scales->len * sizeof (float));
 }
 
 MetaMonitorModeSpec *
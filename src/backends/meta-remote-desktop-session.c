@@ -25,6 +25,7 @@
 #include "backends/meta-remote-desktop-session.h"
 
 #include <linux/input.h>
+#include <math.h>
 #include <xkbcommon/xkbcommon.h>
 #include <stdlib.h>
 
@@ -44,6 +45,30 @@ enum _MetaRemoteDesktopNotifyAxisFlags
   META_REMOTE_DESKTOP_NOTIFY_AXIS_FLAGS_FINISH = 1 << 0,
 } MetaRemoteDesktopNotifyAxisFlags;
 
+typedef enum _MetaRemoteDesktopBatchEventType
+{
+  META_REMOTE_DESKTOP_BATCH_EVENT_KEYBOARD_KEYCODE = 1,
+  META_REMOTE_DESKTOP_BATCH_EVENT_KEYBOARD_KEYSYM = 2,
+  META_REMOTE_DESKTOP_BATCH_EVENT_POINTER_BUTTON = 3,
+  META_REMOTE_DESKTOP_BATCH_EVENT_POINTER_AXIS = 4,
+  META_REMOTE_DESKTOP_BATCH_EVENT_POINTER_AXIS_DISCRETE = 5,
+  META_REMOTE_DESKTOP_BATCH_EVENT_POINTER_MOTION_RELATIVE = 6,
+  META_REMOTE_DESKTOP_BATCH_EVENT_POINTER_MOTION_ABSOLUTE = 7,
+  META_REMOTE_DESKTOP_BATCH_EVENT_TOUCH_DOWN = 8,
+  META_REMOTE_DESKTOP_BATCH_EVENT_TOUCH_MOTION = 9,
+  META_REMOTE_DESKTOP_BATCH_EVENT_TOUCH_UP = 10,
+} MetaRemoteDesktopBatchEventType;
+
+typedef struct _MetaRemoteDesktopBatchEvent
+{
+  MetaRemoteDesktopBatchEventType type;
+  uint64_t time_us;
+  unsigned int code;
+  unsigned int state;
+  double x;
+  double y;
+} MetaRemoteDesktopBatchEvent;
+
 struct _MetaRemoteDesktopSession
 {
   MetaDBusRemoteDesktopSessionSkeleton parent;
@@ -346,58 +371,42 @@ handle_stop (MetaDBusRemoteDesktopSession *skeleton,
   return TRUE;
 }
 
-static gboolean
-handle_notify_keyboard_keycode (MetaDBusRemoteDesktopSession *skeleton,
-                                GDBusMethodInvocation        *invocation,
-                                unsigned int                  keycode,
-                                gboolean                      pressed)
+static void
+notify_keyboard_keycode (MetaRemoteDesktopSession *session,
+                         uint64_t                  time_us,
+                         unsigned int              keycode,
+                         gboolean                  pressed)
 {
-  MetaRemoteDesktopSession *session = META_REMOTE_DESKTOP_SESSION (skeleton);
   ClutterKeyState state;
 
-  if (!meta_remote_desktop_session_check_can_notify (session, invocation))
-    return TRUE;
-
   if (pressed)
     state = CLUTTER_KEY_STATE_PRESSED;
   else
     state = CLUTTER_KEY_STATE_RELEASED;
 
   clutter_virtual_input_device_notify_key (session->virtual_keyboard,
-                                           CLUTTER_CURRENT_TIME,
+                                           time_us,
                                            keycode,
                                            state);
-
-  meta_dbus_remote_desktop_session_complete_notify_keyboard_keycode (skeleton,
-                                                                     invocation);
-  return TRUE;
 }
 
-static gboolean
-handle_notify_keyboard_keysym (MetaDBusRemoteDesktopSession *skeleton,
-                               GDBusMethodInvocation        *invocation,
-                               unsigned int                  keysym,
-                               gboolean                      pressed)
+static void
+notify_keyboard_keysym (MetaRemoteDesktopSession *session,
+                        uint64_t                  time_us,
+                        unsigned int              keysym,
+                        gboolean                  pressed)
 {
-  MetaRemoteDesktopSession *session = META_REMOTE_DESKTOP_SESSION (skeleton);
   ClutterKeyState state;
 
-  if (!meta_remote_desktop_session_check_can_notify (session, invocation))
-    return TRUE;
-
   if (pressed)
     state = CLUTTER_KEY_STATE_PRESSED;
   else
     state = CLUTTER_KEY_STATE_RELEASED;
 
   clutter_virtual_input_device_notify_keyval (session->virtual_keyboard,
-                                              CLUTTER_CURRENT_TIME,
+                                              time_us,
                                               keysym,
                                               state);
-
-  meta_dbus_remote_desktop_session_complete_notify_keyboard_keysym (skeleton,
-                                                                    invocation);
-  return TRUE;
 }
 
 /* Translation taken from the clutter evdev backend. */
@@ -421,19 +430,15 @@ translate_to_clutter_button (int button)
     }
 }
 
-static gboolean
-handle_notify_pointer_button (MetaDBusRemoteDesktopSession *skeleton,
-                              GDBusMethodInvocation        *invocation,
-                              int                           button_code,
-                              gboolean                      pressed)
+static void
+notify_pointer_button (MetaRemoteDesktopSession *session,
+                       uint64_t                  time_us,
+                       int                       button_code,
+                       gboolean                  pressed)
 {
-  MetaRemoteDesktopSession *session = META_REMOTE_DESKTOP_SESSION (skeleton);
   uint32_t button;
   ClutterButtonState state;
 
-  if (!meta_remote_desktop_session_check_can_notify (session, invocation))
-    return TRUE;
-
   button = translate_to_clutter_button (button_code);
 
   if (pressed)
@@ -442,29 +447,20 @@ handle_notify_pointer_button (MetaDBusRemoteDesktopSession *skeleton,
     state = CLUTTER_BUTTON_STATE_RELEASED;
 
   clutter_virtual_input_device_notify_button (session->virtual_pointer,
-                                              CLUTTER_CURRENT_TIME,
+                                              time_us,
                                               button,
                                               state);
-
-  meta_dbus_remote_desktop_session_complete_notify_pointer_button (skeleton,
-                                                                   invocation);
-
-  return TRUE;
 }
 
-static gboolean
-handle_notify_pointer_axis (MetaDBusRemoteDesktopSession *skeleton,
-                            GDBusMethodInvocation        *invocation,
-                            double                        dx,
-                            double                        dy,
-                            uint32_t                      flags)
+static void
+notify_pointer_axis (MetaRemoteDesktopSession *session,
+                     uint64_t                  time_us,
+                     double                    dx,
+                     double                    dy,
+                     uint32_t                  flags)
 {
-  MetaRemoteDesktopSession *session = META_REMOTE_DESKTOP_SESSION (skeleton);
   ClutterScrollFinishFlags finish_flags = CLUTTER_SCROLL_FINISHED_NONE;
 
-  if (!meta_remote_desktop_session_check_can_notify (session, invocation))
-    return TRUE;
-
   if (flags & META_REMOTE_DESKTOP_NOTIFY_AXIS_FLAGS_FINISH)
     {
       finish_flags |= (CLUTTER_SCROLL_FINISHED_HORIZONTAL |
@@ -472,15 +468,10 @@ handle_notify_pointer_axis (MetaDBusRemoteDesktopSession *skeleton,
     }
 
   clutter_virtual_input_device_notify_scroll_continuous (session->virtual_pointer,
-                                                         CLUTTER_CURRENT_TIME,
+                                                         time_us,
                                                          dx, dy,
                                                          CLUTTER_SCROLL_SOURCE_FINGER,
                                                          finish_flags);
-
-  meta_dbus_remote_desktop_session_complete_notify_pointer_axis (skeleton,
-                                                                 invocation);
-
-  return TRUE;
 }
 
 static ClutterScrollDirection
@@ -500,6 +491,194 @@ discrete_steps_to_scroll_direction (unsigned int axis,
   return 0;
 }
 
+static void
+notify_pointer_axis_discrete (MetaRemoteDesktopSession *session,
+                              uint64_t                  time_us,
+                              unsigned int              axis,
+                              int                       steps)
+{
+  ClutterScrollDirection direction;
+  int step_count;
+
+  /*
+   * We don't have the actual scroll source, but only know they should be
+   * considered as discrete steps. The device that produces such scroll events
+   * is the scroll wheel, so pretend that is the scroll source.
+   */
+  direction = discrete_steps_to_scroll_direction (axis, steps);
+
+  for (step_count = 0; step_count < abs (steps); step_count++)
+    clutter_virtual_input_device_notify_discrete_scroll (session->virtual_pointer,
+                                                         time_us,
+                                                         direction,
+                                                         CLUTTER_SCROLL_SOURCE_WHEEL);
+}
+
+static void
+notify_pointer_motion_relative (MetaRemoteDesktopSession *session,
+                                uint64_t                  time_us,
+                                double                    dx,
+                                double                    dy)
+{
+  clutter_virtual_input_device_notify_relative_motion (session->virtual_pointer,
+                                                       time_us,
+                                                       dx, dy);
+}
+
+static void
+notify_pointer_motion_absolute (MetaRemoteDesktopSession *session,
+                                uint64_t                  time_us,
+                                double                    abs_x,
+                                double                    abs_y)
+{
+  clutter_virtual_input_device_notify_absolute_motion (session->virtual_pointer,
+                                                       time_us,
+                                                       abs_x, abs_y);
+}
+
+static void
+notify_touch_down (MetaRemoteDesktopSession *session,
+                   uint64_t                  time_us,
+                   unsigned int              slot,
+                   double                    abs_x,
+                   double                    abs_y)
+{
+  clutter_virtual_input_device_notify_touch_down (session->virtual_touchscreen,
+                                                  time_us,
+                                                  slot,
+                                                  abs_x, abs_y);
+}
+
+static void
+notify_touch_motion (MetaRemoteDesktopSession *session,
+                     uint64_t                  time_us,
+                     unsigned int              slot,
+                     double                    abs_x,
+                     double                    abs_y)
+{
+  clutter_virtual_input_device_notify_touch_motion (session->virtual_touchscreen,
+                                                    time_us,
+                                                    slot,
+                                                    abs_x, abs_y);
+}
+
+static void
+notify_touch_up (MetaRemoteDesktopSession *session,
+                 uint64_t                  time_us,
+                 unsigned int              slot)
+{
+  clutter_virtual_input_device_notify_touch_up (session->virtual_touchscreen,
+                                                time_us,
+                                                slot);
+}
+
+static gboolean
+transform_stream_position (MetaRemoteDesktopSession  *session,
+                           const char                *stream_path,
+                           double                     x,
+                           double                     y,
+                           double                    *abs_x,
+                           double                    *abs_y,
+                           GError                   **error)
+{
+  MetaScreenCastStream *stream;
+
+  if (!session->screen_cast_session)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                   "No screen cast active");
+      return FALSE;
+    }
+
+  stream = meta_screen_cast_session_get_stream (session->screen_cast_session,
+                                                stream_path);
+  if (!stream)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                   "Unknown stream");
+      return FALSE;
+    }
+
+  meta_screen_cast_stream_transform_position (stream, x, y, abs_x, abs_y);
+
+  return TRUE;
+}
+
+static gboolean
+handle_notify_keyboard_keycode (MetaDBusRemoteDesktopSession *skeleton,
+                                GDBusMethodInvocation        *invocation,
+                                unsigned int                  keycode,
+                                gboolean                      pressed)
+{
+  MetaRemoteDesktopSession *session = META_REMOTE_DESKTOP_SESSION (skeleton);
+
+  if (!meta_remote_desktop_session_check_can_notify (session, invocation))
+    return TRUE;
+
+  notify_keyboard_keycode (session, CLUTTER_CURRENT_TIME, keycode, pressed);
+
+  meta_dbus_remote_desktop_session_complete_notify_keyboard_keycode (skeleton,
+                                                                     invocation);
+  return TRUE;
+}
+
+static gboolean
+handle_notify_keyboard_keysym (MetaDBusRemoteDesktopSession *skeleton,
+                               GDBusMethodInvocation        *invocation,
+                               unsigned int                  keysym,
+                               gboolean                      pressed)
+{
+  MetaRemoteDesktopSession *session = META_REMOTE_DESKTOP_SESSION (skeleton);
+
+  if (!meta_remote_desktop_session_check_can_notify (session, invocation))
+    return TRUE;
+
+  notify_keyboard_keysym (session, CLUTTER_CURRENT_TIME, keysym, pressed);
+
+  meta_dbus_remote_desktop_session_complete_notify_keyboard_keysym (skeleton,
+                                                                    invocation);
+  return TRUE;
+}
+
+static gboolean
+handle_notify_pointer_button (MetaDBusRemoteDesktopSession *skeleton,
+                              GDBusMethodInvocation        *invocation,
+                              int                           button_code,
+                              gboolean                      pressed)
+{
+  MetaRemoteDesktopSession *session = META_REMOTE_DESKTOP_SESSION (skeleton);
+
+  if (!meta_remote_desktop_session_check_can_notify (session, invocation))
+    return TRUE;
+
+  notify_pointer_button (session, CLUTTER_CURRENT_TIME, button_code, pressed);
+
+  meta_dbus_remote_desktop_session_complete_notify_pointer_button (skeleton,
+                                                                   invocation);
+
+  return TRUE;
+}
+
+static gboolean
+handle_notify_pointer_axis (MetaDBusRemoteDesktopSession *skeleton,
+                            GDBusMethodInvocation        *invocation,
+                            double                        dx,
+                            double                        dy,
+                            uint32_t                      flags)
+{
+  MetaRemoteDesktopSession *session = META_REMOTE_DESKTOP_SESSION (skeleton);
+
+  if (!meta_remote_desktop_session_check_can_notify (session, invocation))
+    return TRUE;
+
+  notify_pointer_axis (session, CLUTTER_CURRENT_TIME, dx, dy, flags);
+
+  meta_dbus_remote_desktop_session_complete_notify_pointer_axis (skeleton,
+                                                                 invocation);
+
+  return TRUE;
+}
+
 static gboolean
 handle_notify_pointer_axis_discrete (MetaDBusRemoteDesktopSession *skeleton,
                                      GDBusMethodInvocation        *invocation,
@@ -507,8 +686,6 @@ handle_notify_pointer_axis_discrete (MetaDBusRemoteDesktopSession *skeleton,
                                      int                           steps)
 {
   MetaRemoteDesktopSession *session = META_REMOTE_DESKTOP_SESSION (skeleton);
-  ClutterScrollDirection direction;
-  int step_count;
 
   if (!meta_remote_desktop_session_check_can_notify (session, invocation))
     return TRUE;
@@ -529,18 +706,7 @@ handle_notify_pointer_axis_discrete (MetaDBusRemoteDesktopSession *skeleton,
       return TRUE;
     }
 
-  /*
-   * We don't have the actual scroll source, but only know they should be
-   * considered as discrete steps. The device that produces such scroll events
-   * is the scroll wheel, so pretend that is the scroll source.
-   */
-  direction = discrete_steps_to_scroll_direction (axis, steps);
-
-  for (step_count = 0; step_count < abs (steps); step_count++)
-    clutter_virtual_input_device_notify_discrete_scroll (session->virtual_pointer,
-                                                         CLUTTER_CURRENT_TIME,
-                                                         direction,
-                                                         CLUTTER_SCROLL_SOURCE_WHEEL);
+  notify_pointer_axis_discrete (session, CLUTTER_CURRENT_TIME, axis, steps);
 
   meta_dbus_remote_desktop_session_complete_notify_pointer_axis_discrete (skeleton,
                                                                           invocation);
@@ -559,9 +725,7 @@ handle_notify_pointer_motion_relative (MetaDBusRemoteDesktopSession *skeleton,
   if (!meta_remote_desktop_session_check_can_notify (session, invocation))
     return TRUE;
 
-  clutter_virtual_input_device_notify_relative_motion (session->virtual_pointer,
-                                                       CLUTTER_CURRENT_TIME,
-                                                       dx, dy);
+  notify_pointer_motion_relative (session, CLUTTER_CURRENT_TIME, dx, dy);
 
   meta_dbus_remote_desktop_session_complete_notify_pointer_motion_relative (skeleton,
                                                                             invocation);
@@ -577,36 +741,22 @@ handle_notify_pointer_motion_absolute (MetaDBusRemoteDesktopSession *skeleton,
                                        double                        y)
 {
   MetaRemoteDesktopSession *session = META_REMOTE_DESKTOP_SESSION (skeleton);
-  MetaScreenCastStream *stream;
+  g_autoptr (GError) error = NULL;
   double abs_x, abs_y;
 
   if (!meta_remote_desktop_session_check_can_notify (session, invocation))
     return TRUE;
 
-
-  if (!session->screen_cast_session)
-    {
-      g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
-                                             G_DBUS_ERROR_FAILED,
-                                             "No screen cast active");
-      return TRUE;
-    }
-
-  stream = meta_screen_cast_session_get_stream (session->screen_cast_session,
-                                                stream_path);
-  if (!stream)
+  if (!transform_stream_position (session, stream_path, x, y,
+                                  &abs_x, &abs_y, &error))
     {
-      g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
-                                             G_DBUS_ERROR_FAILED,
-                                             "Unknown stream");
+      g_dbus_method_invocation_return_error_literal (invocation, G_DBUS_ERROR,
+                                                     G_DBUS_ERROR_FAILED,
+                                                     error->message);
       return TRUE;
     }
 
-  meta_screen_cast_stream_transform_position (stream, x, y, &abs_x, &abs_y);
-
-  clutter_virtual_input_device_notify_absolute_motion (session->virtual_pointer,
-                                                       CLUTTER_CURRENT_TIME,
-                                                       abs_x, abs_y);
+  notify_pointer_motion_absolute (session, CLUTTER_CURRENT_TIME, abs_x, abs_y);
 
   meta_dbus_remote_desktop_session_complete_notify_pointer_motion_absolute (skeleton,
                                                                             invocation);
@@ -623,36 +773,22 @@ handle_notify_touch_down (MetaDBusRemoteDesktopSession *skeleton,
                           double                        y)
 {
   MetaRemoteDesktopSession *session = META_REMOTE_DESKTOP_SESSION (skeleton);
-  MetaScreenCastStream *stream;
+  g_autoptr (GError) error = NULL;
   double abs_x, abs_y;
 
   if (!meta_remote_desktop_session_check_can_notify (session, invocation))
     return TRUE;
 
-  if (!session->screen_cast_session)
+  if (!transform_stream_position (session, stream_path, x, y,
+                                  &abs_x, &abs_y, &error))
     {
-      g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
-                                             G_DBUS_ERROR_FAILED,
-                                             "No screen cast active");
-      return TRUE;
-    }
-
-  stream = meta_screen_cast_session_get_stream (session->screen_cast_session,
-                                                stream_path);
-  if (!stream)
-    {
-      g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
-                                             G_DBUS_ERROR_FAILED,
-                                             "Unknown stream");
+      g_dbus_method_invocation_return_error_literal (invocation, G_DBUS_ERROR,
+                                                     G_DBUS_ERROR_FAILED,
+                                                     error->message);
       return TRUE;
     }
 
-  meta_screen_cast_stream_transform_position (stream, x, y, &abs_x, &abs_y);
-
-  clutter_virtual_input_device_notify_touch_down (session->virtual_touchscreen,
-                                                  CLUTTER_CURRENT_TIME,
-                                                  slot,
-                                                  abs_x, abs_y);
+  notify_touch_down (session, CLUTTER_CURRENT_TIME, slot, abs_x, abs_y);
 
   meta_dbus_remote_desktop_session_complete_notify_touch_down (skeleton,
                                                                invocation);
@@ -669,37 +805,22 @@ handle_notify_touch_motion (MetaDBusRemoteDesktopSession *skeleton,
                             double                        y)
 {
   MetaRemoteDesktopSession *session = META_REMOTE_DESKTOP_SESSION (skeleton);
-  MetaScreenCastStream *stream;
+  g_autoptr (GError) error = NULL;
   double abs_x, abs_y;
 
   if (!meta_remote_desktop_session_check_can_notify (session, invocation))
     return TRUE;
 
-
-  if (!session->screen_cast_session)
+  if (!transform_stream_position (session, stream_path, x, y,
+                                  &abs_x, &abs_y, &error))
     {
-      g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
-                                             G_DBUS_ERROR_FAILED,
-                                             "No screen cast active");
-      return TRUE;
-    }
-
-  stream = meta_screen_cast_session_get_stream (session->screen_cast_session,
-                                                stream_path);
-  if (!stream)
-    {
-      g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
-                                             G_DBUS_ERROR_FAILED,
-                                             "Unknown stream");
+      g_dbus_method_invocation_return_error_literal (invocation, G_DBUS_ERROR,
+                                                     G_DBUS_ERROR_FAILED,
+                                                     error->message);
       return TRUE;
     }
 
-  meta_screen_cast_stream_transform_position (stream, x, y, &abs_x, &abs_y);
-
-  clutter_virtual_input_device_notify_touch_motion (session->virtual_touchscreen,
-                                                    CLUTTER_CURRENT_TIME,
-                                                    slot,
-                                                    abs_x, abs_y);
+  notify_touch_motion (session, CLUTTER_CURRENT_TIME, slot, abs_x, abs_y);
 
   meta_dbus_remote_desktop_session_complete_notify_touch_motion (skeleton,
                                                                  invocation);
@@ -709,17 +830,15 @@ handle_notify_touch_motion (MetaDBusRemoteDesktopSession *skeleton,
 
 static gboolean
 handle_notify_touch_up (MetaDBusRemoteDesktopSession *skeleton,
-                          GDBusMethodInvocation        *invocation,
-                          unsigned int                  slot)
+                        GDBusMethodInvocation        *invocation,
+                        unsigned int                  slot)
 {
   MetaRemoteDesktopSession *session = META_REMOTE_DESKTOP_SESSION (skeleton);
 
   if (!meta_remote_desktop_session_check_can_notify (session, invocation))
     return TRUE;
 
-  clutter_virtual_input_device_notify_touch_up (session->virtual_touchscreen,
-                                                       CLUTTER_CURRENT_TIME,
-                                                       slot);
+  notify_touch_up (session, CLUTTER_CURRENT_TIME, slot);
 
   meta_dbus_remote_desktop_session_complete_notify_touch_up (skeleton,
                                                              invocation);
@@ -727,6 +846,189 @@ handle_notify_touch_up (MetaDBusRemoteDesktopSession *skeleton,
   return TRUE;
 }
 
+static GArray *
+parse_batch (MetaRemoteDesktopSession  *session,
+             GVariant                  *events,
+             GError                   **error)
+{
+  g_autoptr (GArray) batch = NULL;
+  GVariantIter iter;
+  unsigned int type;
+  uint64_t time_us;
+  const char *stream_path;
+  unsigned int code;
+  unsigned int state;
+  double x, y;
+
+  batch = g_array_sized_new (FALSE, FALSE,
+                             sizeof (MetaRemoteDesktopBatchEvent),
+                             g_variant_n_children (events));
+
+  g_variant_iter_init (&iter, events);
+  while (g_variant_iter_next (&iter, "(ut&suudd)",
+                              &type, &time_us, &stream_path,
+                              &code, &state, &x, &y))
+    {
+      MetaRemoteDesktopBatchEvent event = { 0 };
+
+      if (batch->len > 0 &&
+          time_us < g_array_index (batch, MetaRemoteDesktopBatchEvent,
+                                   batch->len - 1).time_us)
+        {
+          g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                       "Event %u goes back in time", batch->len);
+          return NULL;
+        }
+
+      event.type = type;
+      event.time_us = time_us;
+      event.code = code;
+      event.state = state;
+      event.x = x;
+      event.y = y;
+
+      switch (event.type)
+        {
+        case META_REMOTE_DESKTOP_BATCH_EVENT_KEYBOARD_KEYCODE:
+        case META_REMOTE_DESKTOP_BATCH_EVENT_KEYBOARD_KEYSYM:
+        case META_REMOTE_DESKTOP_BATCH_EVENT_POINTER_BUTTON:
+        case META_REMOTE_DESKTOP_BATCH_EVENT_POINTER_AXIS:
+        case META_REMOTE_DESKTOP_BATCH_EVENT_POINTER_MOTION_RELATIVE:
+        case META_REMOTE_DESKTOP_BATCH_EVENT_TOUCH_UP:
+          break;
+        case META_REMOTE_DESKTOP_BATCH_EVENT_POINTER_AXIS_DISCRETE:
+          /* The steps are passed as the x coordinate; make sure they fit
+           * an int before converting them.
+           */
+          if (event.code > 1 ||
+              !isfinite (event.x) ||
+              fabs (event.x) > G_MAXINT ||
+              (int) event.x == 0)
+            {
+              g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                           "Invalid axis or axis steps value in event %u",
+                           batch->len);
+              return NULL;
+            }
+          break;
+        case META_REMOTE_DESKTOP_BATCH_EVENT_POINTER_MOTION_ABSOLUTE:
+        case META_REMOTE_DESKTOP_BATCH_EVENT_TOUCH_DOWN:
+        case META_REMOTE_DESKTOP_BATCH_EVENT_TOUCH_MOTION:
+          if (!transform_stream_position (session, stream_path, x, y,
+                                          &event.x, &event.y,
+                                          error))
+            return NULL;
+          break;
+        default:
+          g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                       "Unknown type %u of event %u", type, batch->len);
+          return NULL;
+        }
+
+      g_array_append_val (batch, event);
+    }
+
+  return g_steal_pointer (&batch);
+}
+
+static void
+notify_batch_event (MetaRemoteDesktopSession    *session,
+                    MetaRemoteDesktopBatchEvent *event,
+                    uint64_t                     time_us)
+{
+  switch (event->type)
+    {
+    case META_REMOTE_DESKTOP_BATCH_EVENT_KEYBOARD_KEYCODE:
+      notify_keyboard_keycode (session, time_us, event->code, event->state);
+      break;
+    case META_REMOTE_DESKTOP_BATCH_EVENT_KEYBOARD_KEYSYM:
+      notify_keyboard_keysym (session, time_us, event->code, event->state);
+      break;
+    case META_REMOTE_DESKTOP_BATCH_EVENT_POINTER_BUTTON:
+      notify_pointer_button (session, time_us, event->code, event->state);
+      break;
+    case META_REMOTE_DESKTOP_BATCH_EVENT_POINTER_AXIS:
+      notify_pointer_axis (session, time_us, event->x, event->y, event->state);
+      break;
+    case META_REMOTE_DESKTOP_BATCH_EVENT_POINTER_AXIS_DISCRETE:
+      notify_pointer_axis_discrete (session, time_us,
+                                    event->code, (int) event->x);
+      break;
+    case META_REMOTE_DESKTOP_BATCH_EVENT_POINTER_MOTION_RELATIVE:
+      notify_pointer_motion_relative (session, time_us, event->x, event->y);
+      break;
+    case META_REMOTE_DESKTOP_BATCH_EVENT_POINTER_MOTION_ABSOLUTE:
+      notify_pointer_motion_absolute (session, time_us, event->x, event->y);
+      break;
+    case META_REMOTE_DESKTOP_BATCH_EVENT_TOUCH_DOWN:
+      notify_touch_down (session, time_us, event->code, event->x, event->y);
+      break;
+    case META_REMOTE_DESKTOP_BATCH_EVENT_TOUCH_MOTION:
+      notify_touch_motion (session, time_us, event->code, event->x, event->y);
+      break;
+    case META_REMOTE_DESKTOP_BATCH_EVENT_TOUCH_UP:
+      notify_touch_up (session, time_us, event->code);
+      break;
+    }
+}
+
+static gboolean
+handle_notify_batch (MetaDBusRemoteDesktopSession *skeleton,
+                     GDBusMethodInvocation        *invocation,
+                     GVariant                     *events)
+{
+  MetaRemoteDesktopSession *session = META_REMOTE_DESKTOP_SESSION (skeleton);
+  g_autoptr (GArray) batch = NULL;
+  g_autoptr (GError) error = NULL;
+  MetaRemoteDesktopBatchEvent *last_event;
+  int64_t now_us;
+  unsigned int i;
+
+  if (!meta_remote_desktop_session_check_can_notify (session, invocation))
+    return TRUE;
+
+  /* Validate the whole batch first, so it's either processed entirely or
+   * not at all. */
+  batch = parse_batch (session, events, &error);
+  if (!batch)
+    {
+      g_dbus_method_invocation_return_error (invocation, G_DBUS_ERROR,
+                                             G_DBUS_ERROR_INVALID_ARGS,
+                                             "Invalid batch: %s",
+                                             error->message);
+      return TRUE;
+    }
+
+  if (batch->len > 0)
+    {
+      /* Keep the relative timing of the events, with the last one
+       * happening now. */
+      now_us = g_get_monotonic_time ();
+      last_event = &g_array_index (batch, MetaRemoteDesktopBatchEvent,
+                                   batch->len - 1);
+
+      for (i = 0; i < batch->len; i++)
+        {
+          MetaRemoteDesktopBatchEvent *event =
+            &g_array_index (batch, MetaRemoteDesktopBatchEvent, i);
+          uint64_t age_us = last_event->time_us - event->time_us;
+          uint64_t time_us;
+
+          if (age_us < (uint64_t) now_us)
+            time_us = now_us - age_us;
+          else
+            time_us = 1;
+
+          notify_batch_event (session, event, time_us);
+        }
+    }
+
+  meta_dbus_remote_desktop_session_complete_notify_batch (skeleton,
+                                                          invocation);
+
+  return TRUE;
+}
+
 static void
 meta_remote_desktop_session_init_iface (MetaDBusRemoteDesktopSessionIface *iface)
 {
@@ -742,6 +1044,7 @@ meta_remote_desktop_session_init_iface (MetaDBusRemoteDesktopSessionIface *iface
   iface->handle_notify_touch_down = handle_notify_touch_down;
   iface->handle_notify_touch_motion = handle_notify_touch_motion;
   iface->handle_notify_touch_up = handle_notify_touch_up;
+  iface->handle_notify_batch = handle_notify_batch;
 }
 
 static void
@@ -73,6 +73,11 @@
  */
 #define HW_CURSOR_BUFFER_COUNT 3
 
+/* Number of scale and transform combinations to keep preprocessed cursor
+ * images around for, e.g. when moving between monitors with different
+ * scales. */
+#define MAX_FRAME_CACHES 4
+
 static GQuark quark_cursor_sprite = 0;
 
 struct _MetaCursorRendererNative
@@ -115,10 +120,24 @@ typedef struct _MetaCursorNativeGpuState
   struct gbm_bo *bos[HW_CURSOR_BUFFER_COUNT];
 } MetaCursorNativeGpuState;
 
+typedef struct _MetaCursorNativeFrameCache
+{
+  float scale;
+  MetaMonitorTransform transform;
+
+  int n_frames;
+  cairo_surface_t **frames;
+} MetaCursorNativeFrameCache;
+
 typedef struct _MetaCursorNativePrivate
 {
   GHashTable *gpu_states;
 
+  struct {
+    unsigned int images_serial;
+    GList *entries;
+  } frame_caches;
+
   struct {
     gboolean can_preprocess;
     float current_relative_scale;
@@ -1131,9 +1150,22 @@ on_cursor_sprite_texture_changed (MetaCursorSprite *cursor_sprite)
   invalidate_cursor_gpu_state (cursor_sprite);
 }
 
+static void
+frame_cache_free (MetaCursorNativeFrameCache *frame_cache)
+{
+  int i;
+
+  for (i = 0; i < frame_cache->n_frames; i++)
+    cairo_surface_destroy (frame_cache->frames[i]);
+  g_free (frame_cache->frames);
+  g_free (frame_cache);
+}
+
 static void
 cursor_priv_free (MetaCursorNativePrivate *cursor_priv)
 {
+  g_list_free_full (cursor_priv->frame_caches.entries,
+                    (GDestroyNotify) frame_cache_free);
   g_hash_table_destroy (cursor_priv->gpu_states);
   g_free (cursor_priv);
 }
@@ -1386,7 +1418,7 @@ load_scaled_and_transformed_cursor_sprite (MetaCursorRendererNative *native,
                                              cursor_sprite,
                                              cairo_image_surface_get_data (surface),
                                              cairo_image_surface_get_width (surface),
-                                             cairo_image_surface_get_width (surface),
+                                             cairo_image_surface_get_height (surface),
                                              cairo_image_surface_get_stride (surface),
                                              gbm_format);
 
@@ -1405,6 +1437,97 @@ load_scaled_and_transformed_cursor_sprite (MetaCursorRendererNative *native,
     }
 }
 
+static MetaCursorNativeFrameCache *
+frame_cache_new (XcursorImages        *xcursor_images,
+                 float                 scale,
+                 MetaMonitorTransform  transform)
+{
+  MetaCursorNativeFrameCache *frame_cache;
+  int i;
+
+  frame_cache = g_new0 (MetaCursorNativeFrameCache, 1);
+  frame_cache->scale = scale;
+  frame_cache->transform = transform;
+  frame_cache->n_frames = xcursor_images->nimage;
+  frame_cache->frames = g_new0 (cairo_surface_t *, frame_cache->n_frames);
+
+  for (i = 0; i < frame_cache->n_frames; i++)
+    {
+      XcursorImage *xc_image = xcursor_images->images[i];
+
+      frame_cache->frames[i] =
+        scale_and_transform_cursor_sprite_cpu ((uint8_t *) xc_image->pixels,
+                                               xc_image->width,
+                                               xc_image->height,
+                                               xc_image->width * 4,
+                                               scale,
+                                               transform);
+    }
+
+  return frame_cache;
+}
+
+/*
+ * Returns the current frame of the xcursor sprite scaled and transformed
+ * as requested. All frames are converted at once the first time a scale
+ * and transform combination is needed, so that animated cursors don't
+ * have to go through cairo on each frame.
+ */
+static cairo_surface_t *
+ensure_scaled_and_transformed_xcursor_frame (MetaCursorSpriteXcursor *sprite_xcursor,
+                                             float                    scale,
+                                             MetaMonitorTransform     transform)
+{
+  MetaCursorSprite *cursor_sprite = META_CURSOR_SPRITE (sprite_xcursor);
+  MetaCursorNativePrivate *cursor_priv = get_cursor_priv (cursor_sprite);
+  MetaCursorNativeFrameCache *frame_cache;
+  unsigned int images_serial;
+  int current_frame;
+  GList *l;
+
+  images_serial = meta_cursor_sprite_xcursor_get_images_serial (sprite_xcursor);
+  if (cursor_priv->frame_caches.images_serial != images_serial)
+    {
+      g_list_free_full (g_steal_pointer (&cursor_priv->frame_caches.entries),
+                        (GDestroyNotify) frame_cache_free);
+      cursor_priv->frame_caches.images_serial = images_serial;
+    }
+
+  current_frame = meta_cursor_sprite_xcursor_get_current_frame (sprite_xcursor);
+
+  for (l = cursor_priv->frame_caches.entries; l; l = l->next)
+    {
+      frame_cache = l->data;
+
+      if (!G_APPROX_VALUE (frame_cache->scale, scale, FLT_EPSILON) ||
+          frame_cache->transform != transform)
+        continue;
+
+      cursor_priv->frame_caches.entries =
+        g_list_remove_link (cursor_priv->frame_caches.entries, l);
+      cursor_priv->frame_caches.entries =
+        g_list_concat (l, cursor_priv->frame_caches.entries);
+
+      return frame_cache->frames[current_frame];
+    }
+
+  frame_cache =
+    frame_cache_new (meta_cursor_sprite_xcursor_get_images (sprite_xcursor),
+                     scale, transform);
+  cursor_priv->frame_caches.entries =
+    g_list_prepend (cursor_priv->frame_caches.entries, frame_cache);
+
+  if (g_list_length (cursor_priv->frame_caches.entries) > MAX_FRAME_CACHES)
+    {
+      l = g_list_last (cursor_priv->frame_caches.entries);
+      frame_cache_free (l->data);
+      cursor_priv->frame_caches.entries =
+        g_list_delete_link (cursor_priv->frame_caches.entries, l);
+    }
+
+  return frame_cache->frames[current_frame];
+}
+
 #ifdef HAVE_WAYLAND
 static void
 realize_cursor_sprite_from_wl_buffer_for_gpu (MetaCursorRenderer      *renderer,
@@ -1586,18 +1709,37 @@ realize_cursor_sprite_from_xcursor_for_gpu (MetaCursorRenderer      *renderer,
                       relative_scale,
                       relative_transform);
 
-  xc_image = meta_cursor_sprite_xcursor_get_current_image (sprite_xcursor);
+  if (!G_APPROX_VALUE (relative_scale, 1.f, FLT_EPSILON) ||
+      relative_transform != META_MONITOR_TRANSFORM_NORMAL)
+    {
+      cairo_surface_t *surface;
+
+      surface = ensure_scaled_and_transformed_xcursor_frame (sprite_xcursor,
+                                                             relative_scale,
+                                                             relative_transform);
+
+      load_cursor_sprite_gbm_buffer_for_gpu (native,
+                                             gpu_kms,
+                                             cursor_sprite,
+                                             cairo_image_surface_get_data (surface),
+                                             cairo_image_surface_get_width (surface),
+                                             cairo_image_surface_get_height (surface),
+                                             cairo_image_surface_get_stride (surface),
+                                             GBM_FORMAT_ARGB8888);
+    }
+  else
+    {
+      xc_image = meta_cursor_sprite_xcursor_get_current_image (sprite_xcursor);
 
-  load_scaled_and_transformed_cursor_sprite (native,
+      load_cursor_sprite_gbm_buffer_for_gpu (native,
                                              gpu_kms,
                                              cursor_sprite,
-                                             relative_scale,
-                                             relative_transform,
                                              (uint8_t *) xc_image->pixels,
                                              xc_image->width,
                                              xc_image->height,
                                              xc_image->width * 4,
                                              GBM_FORMAT_ARGB8888);
+    }
 }
 
 static void
@@ -37,6 +37,8 @@ struct _MetaEventNative
   double dy;
   double dx_unaccel;
   double dy_unaccel;
+
+  GArray *motion_history;
 };
 
 static MetaEventNative *
@@ -45,20 +47,41 @@ meta_event_native_new (void)
   return g_slice_new0 (MetaEventNative);
 }
 
+static GArray *
+copy_motion_history (GArray *motion_history)
+{
+  GArray *copy;
+
+  copy = g_array_sized_new (FALSE, FALSE, sizeof (MetaEventNativeMotion),
+                            motion_history->len);
+  g_array_append_vals (copy, motion_history->data, motion_history->len);
+
+  return copy;
+}
+
 MetaEventNative *
 meta_event_native_copy (MetaEventNative *event_evdev)
 {
-  if (event_evdev != NULL)
-    return g_slice_dup (MetaEventNative, event_evdev);
+  MetaEventNative *copy;
+
+  if (event_evdev == NULL)
+    return NULL;
 
-  return NULL;
+  copy = g_slice_dup (MetaEventNative, event_evdev);
+  if (event_evdev->motion_history)
+    copy->motion_history = copy_motion_history (event_evdev->motion_history);
+
+  return copy;
 }
 
 void
 meta_event_native_free (MetaEventNative *event_evdev)
 {
   if (event_evdev != NULL)
-    g_slice_free (MetaEventNative, event_evdev);
+    {
+      g_clear_pointer (&event_evdev->motion_history, g_array_unref);
+      g_slice_free (MetaEventNative, event_evdev);
+    }
 }
 
 static MetaEventNative *
@@ -187,6 +210,110 @@ meta_event_native_get_relative_motion (const ClutterEvent *event,
     return FALSE;
 }
 
+static void
+append_motion (GArray             *motion_history,
+               const ClutterEvent *event,
+               MetaEventNative    *event_evdev)
+{
+  MetaEventNativeMotion motion = { 0 };
+
+  if (event_evdev && event_evdev->time_usec)
+    motion.time_usec = event_evdev->time_usec;
+  else
+    motion.time_usec = clutter_event_get_time (event) * 1000ULL;
+
+  clutter_event_get_coords (event, &motion.x, &motion.y);
+
+  if (event_evdev && event_evdev->has_relative_motion)
+    {
+      motion.has_relative_motion = TRUE;
+      motion.dx = event_evdev->dx;
+      motion.dy = event_evdev->dy;
+      motion.dx_unaccel = event_evdev->dx_unaccel;
+      motion.dy_unaccel = event_evdev->dy_unaccel;
+    }
+
+  g_array_append_val (motion_history, motion);
+}
+
+/**
+ * meta_event_native_add_motion_history:
+ * @event: a motion #ClutterEvent
+ * @discarded: an earlier motion #ClutterEvent that is compressed into @event
+ *
+ * Moves the motion history of @discarded, or its own motion if it has none,
+ * to the front of the motion history of @event. This must be called before
+ * the relative motion of @discarded is accumulated into @event, so the
+ * history records the motion of each individual event.
+ **/
+void
+meta_event_native_add_motion_history (ClutterEvent       *event,
+                                      const ClutterEvent *discarded)
+{
+  MetaEventNative *event_evdev;
+  MetaEventNative *discarded_evdev;
+  GArray *motion_history;
+
+  event_evdev = meta_event_native_ensure_platform_data (event);
+  discarded_evdev = _clutter_event_get_platform_data (discarded);
+
+  /* Events are usually compressed one after another into the next one,
+   * so taking over the history of the discarded event keeps this linear
+   */
+  if (discarded_evdev && discarded_evdev->motion_history)
+    {
+      motion_history = g_steal_pointer (&discarded_evdev->motion_history);
+    }
+  else
+    {
+      motion_history = g_array_new (FALSE, FALSE,
+                                    sizeof (MetaEventNativeMotion));
+      append_motion (motion_history, discarded, discarded_evdev);
+    }
+
+  if (event_evdev->motion_history)
+    {
+      g_array_append_vals (motion_history,
+                           event_evdev->motion_history->data,
+                           event_evdev->motion_history->len);
+      g_array_unref (event_evdev->motion_history);
+    }
+  else
+    {
+      append_motion (motion_history, event, event_evdev);
+    }
+
+  event_evdev->motion_history = motion_history;
+}
+
+/**
+ * meta_event_native_get_motion_history:
+ * @event: a #ClutterEvent
+ * @n_motions: (out): return location for the number of motions
+ *
+ * Retrieves the individual motions of the events that were compressed into
+ * @event, oldest first. The last motion is the one of @event itself. If no
+ * events were compressed into @event, %NULL is returned and @n_motions is
+ * set to 0.
+ *
+ * Returns: (transfer none) (nullable): The motion history of @event.
+ **/
+const MetaEventNativeMotion *
+meta_event_native_get_motion_history (const ClutterEvent *event,
+                                      unsigned int       *n_motions)
+{
+  MetaEventNative *event_evdev = _clutter_event_get_platform_data (event);
+
+  if (!event_evdev || !event_evdev->motion_history)
+    {
+      *n_motions = 0;
+      return NULL;
+    }
+
+  *n_motions = event_evdev->motion_history->len;
+  return (const MetaEventNativeMotion *) event_evdev->motion_history->data;
+}
+
 /**
  * meta_event_native_sequence_get_slot:
  * @sequence: a #ClutterEventSequence
@@ -25,6 +25,19 @@
 
 typedef struct _MetaEventNative MetaEventNative;
 
+typedef struct _MetaEventNativeMotion
+{
+  uint64_t time_usec;
+  float x;
+  float y;
+
+  gboolean has_relative_motion;
+  double dx;
+  double dy;
+  double dx_unaccel;
+  double dy_unaccel;
+} MetaEventNativeMotion;
+
 MetaEventNative * meta_event_native_copy (MetaEventNative *event_evdev);
 void              meta_event_native_free (MetaEventNative *event_evdev);
 
@@ -45,6 +58,12 @@ gboolean          meta_event_native_get_relative_motion (const ClutterEvent *eve
                                                          double             *dx_unaccel,
                                                          double             *dy_unaccel);
 
+void              meta_event_native_add_motion_history (ClutterEvent       *event,
+                                                        const ClutterEvent *discarded);
+const MetaEventNativeMotion *
+                  meta_event_native_get_motion_history (const ClutterEvent *event,
+                                                        unsigned int       *n_motions);
+
 int32_t           meta_event_native_sequence_get_slot (const ClutterEventSequence *sequence);
 
 #endif /* META_EVENT_NATIVE_H */
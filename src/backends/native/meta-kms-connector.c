@@ -456,6 +456,44 @@ meta_kms_connector_state_free (MetaKmsConnectorState *state)
   g_free (state);
 }
 
+static gboolean
+meta_kms_connector_state_equal (MetaKmsConnectorState *state,
+                                MetaKmsConnectorState *other_state)
+{
+  if (!state || !other_state)
+    return state == other_state;
+
+  if (state->current_crtc_id != other_state->current_crtc_id ||
+      state->common_possible_crtcs != other_state->common_possible_crtcs ||
+      state->common_possible_clones != other_state->common_possible_clones ||
+      state->encoder_device_idxs != other_state->encoder_device_idxs ||
+      state->width_mm != other_state->width_mm ||
+      state->height_mm != other_state->height_mm ||
+      state->has_scaling != other_state->has_scaling ||
+      state->non_desktop != other_state->non_desktop ||
+      state->subpixel_order != other_state->subpixel_order ||
+      state->suggested_x != other_state->suggested_x ||
+      state->suggested_y != other_state->suggested_y ||
+      state->hotplug_mode_update != other_state->hotplug_mode_update ||
+      state->panel_orientation_transform !=
+      other_state->panel_orientation_transform)
+    return FALSE;
+
+  if (memcmp (&state->tile_info, &other_state->tile_info,
+              sizeof (MetaTileInfo)) != 0)
+    return FALSE;
+
+  if (state->n_modes != other_state->n_modes ||
+      memcmp (state->modes, other_state->modes,
+              state->n_modes * sizeof (drmModeModeInfo)) != 0)
+    return FALSE;
+
+  if (!state->edid_data || !other_state->edid_data)
+    return state->edid_data == other_state->edid_data;
+
+  return g_bytes_equal (state->edid_data, other_state->edid_data);
+}
+
 static void
 meta_kms_connector_read_state (MetaKmsConnector  *connector,
                                MetaKmsImplDevice *impl_device,
@@ -487,21 +525,29 @@ meta_kms_connector_read_state (MetaKmsConnector  *connector,
   connector->current_state = state;
 }
 
-void
+/*
+ * Returns TRUE if the connector state differs from what it was before.
+ */
+gboolean
 meta_kms_connector_update_state (MetaKmsConnector *connector,
+                                 drmModeConnector *drm_connector,
                                  drmModeRes       *drm_resources)
 {
   MetaKmsImplDevice *impl_device;
-  drmModeConnector *drm_connector;
+  MetaKmsConnectorState *old_state;
+  gboolean changed;
 
   impl_device = meta_kms_device_get_impl_device (connector->device);
-  drm_connector = drmModeGetConnector (meta_kms_impl_device_get_fd (impl_device),
-                                       connector->id);
+
+  old_state = g_steal_pointer (&connector->current_state);
   meta_kms_connector_read_state (connector, impl_device,
                                  drm_connector,
                                  drm_resources);
-  if (drm_connector)
-    drmModeFreeConnector (drm_connector);
+  changed = !meta_kms_connector_state_equal (old_state,
+                                             connector->current_state);
+  g_clear_pointer (&old_state, meta_kms_connector_state_free);
+
+  return changed;
 }
 
 void
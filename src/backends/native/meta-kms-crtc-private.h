@@ -28,7 +28,7 @@ MetaKmsCrtc * meta_kms_crtc_new (MetaKmsImplDevice *impl_device,
                                  drmModeCrtc       *drm_crtc,
                                  int                idx);
 
-void meta_kms_crtc_update_state (MetaKmsCrtc *crtc);
+gboolean meta_kms_crtc_update_state (MetaKmsCrtc *crtc);
 
 void meta_kms_crtc_predict_state (MetaKmsCrtc   *crtc,
                                   MetaKmsUpdate *update);
@@ -25,6 +25,7 @@
 #include "backends/native/meta-kms-device-private.h"
 #include "backends/native/meta-kms-impl-device.h"
 #include "backends/native/meta-kms-update-private.h"
+#include "meta/boxes.h"
 
 struct _MetaKmsCrtc
 {
@@ -123,11 +124,45 @@ meta_kms_crtc_read_state (MetaKmsCrtc       *crtc,
   read_gamma_state (crtc, impl_device, drm_crtc);
 }
 
-void
+static gboolean
+meta_kms_crtc_state_equal (const MetaKmsCrtcState *state,
+                           const MetaKmsCrtcState *other_state)
+{
+  size_t gamma_size;
+
+  if (!meta_rectangle_equal (&state->rect, &other_state->rect) ||
+      state->is_drm_mode_valid != other_state->is_drm_mode_valid)
+    return FALSE;
+
+  if (state->is_drm_mode_valid &&
+      memcmp (&state->drm_mode, &other_state->drm_mode,
+              sizeof (drmModeModeInfo)) != 0)
+    return FALSE;
+
+  if (state->gamma.size != other_state->gamma.size)
+    return FALSE;
+
+  if (state->gamma.size == 0)
+    return TRUE;
+
+  gamma_size = state->gamma.size * sizeof (uint16_t);
+  return (memcmp (state->gamma.red, other_state->gamma.red, gamma_size) == 0 &&
+          memcmp (state->gamma.green, other_state->gamma.green, gamma_size) == 0 &&
+          memcmp (state->gamma.blue, other_state->gamma.blue, gamma_size) == 0);
+}
+
+/*
+ * Returns TRUE if the CRTC state differs from what it was before.
+ */
+gboolean
 meta_kms_crtc_update_state (MetaKmsCrtc *crtc)
 {
   MetaKmsImplDevice *impl_device;
+  MetaKmsCrtcState old_state;
   drmModeCrtc *drm_crtc;
+  gboolean changed;
+
+  old_state = crtc->current_state;
 
   impl_device = meta_kms_device_get_impl_device (crtc->device);
   drm_crtc = drmModeGetCrtc (meta_kms_impl_device_get_fd (impl_device),
@@ -136,11 +171,25 @@ meta_kms_crtc_update_state (MetaKmsCrtc *crtc)
     {
       crtc->current_state.rect = (MetaRectangle) { };
       crtc->current_state.is_drm_mode_valid = FALSE;
-      return;
+      return !meta_kms_crtc_state_equal (&old_state, &crtc->current_state);
     }
 
+  /* Read the gamma ramps into new arrays so they can be compared */
+  crtc->current_state.gamma.size = 0;
+  crtc->current_state.gamma.red = NULL;
+  crtc->current_state.gamma.green = NULL;
+  crtc->current_state.gamma.blue = NULL;
+
   meta_kms_crtc_read_state (crtc, impl_device, drm_crtc);
   drmModeFreeCrtc (drm_crtc);
+
+  changed = !meta_kms_crtc_state_equal (&old_state, &crtc->current_state);
+
+  g_free (old_state.gamma.red);
+  g_free (old_state.gamma.green);
+  g_free (old_state.gamma.blue);
+
+  return changed;
 }
 
 static void
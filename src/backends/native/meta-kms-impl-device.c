@@ -254,11 +254,17 @@ find_existing_connector (MetaKmsImplDevice *impl_device,
   return NULL;
 }
 
-static void
+/*
+ * Probes each connector once, creating new connectors and updating the
+ * state of existing ones from the same probe. Returns TRUE if any connector
+ * appeared, disappeared or changed state.
+ */
+static gboolean
 update_connectors (MetaKmsImplDevice *impl_device,
                    drmModeRes        *drm_resources)
 {
   GList *connectors = NULL;
+  gboolean changed = FALSE;
   unsigned int i;
 
   for (i = 0; i < drm_resources->count_connectors; i++)
@@ -273,17 +279,30 @@ update_connectors (MetaKmsImplDevice *impl_device,
 
       connector = find_existing_connector (impl_device, drm_connector);
       if (connector)
-        connector = g_object_ref (connector);
+        {
+          connector = g_object_ref (connector);
+          if (meta_kms_connector_update_state (connector, drm_connector,
+                                               drm_resources))
+            changed = TRUE;
+        }
       else
-        connector = meta_kms_connector_new (impl_device, drm_connector,
-                                            drm_resources);
+        {
+          connector = meta_kms_connector_new (impl_device, drm_connector,
+                                              drm_resources);
+          changed = TRUE;
+        }
       drmModeFreeConnector (drm_connector);
 
       connectors = g_list_prepend (connectors, connector);
     }
 
+  if (g_list_length (connectors) != g_list_length (impl_device->connectors))
+    changed = TRUE;
+
   g_list_free_full (impl_device->connectors, g_object_unref);
   impl_device->connectors = g_list_reverse (connectors);
+
+  return changed;
 }
 
 static MetaKmsPlaneType
@@ -388,32 +407,47 @@ init_info (MetaKmsImplDevice *impl_device)
   drmFreeVersion (drm_version);
 }
 
-void
+/*
+ * Returns TRUE if the connector or CRTC state changed, i.e. the monitor
+ * configuration needs to be re-read.
+ */
+gboolean
 meta_kms_impl_device_update_states (MetaKmsImplDevice *impl_device)
 {
   drmModeRes *drm_resources;
+  gboolean changed;
+  GList *l;
 
   meta_assert_in_kms_impl (meta_kms_impl_get_kms (impl_device->impl));
 
   drm_resources = drmModeGetResources (impl_device->fd);
   if (!drm_resources)
     {
+      changed = (impl_device->connectors != NULL ||
+                 impl_device->crtcs != NULL);
+
       g_list_free_full (impl_device->planes, g_object_unref);
       g_list_free_full (impl_device->crtcs, g_object_unref);
       g_list_free_full (impl_device->connectors, g_object_unref);
       impl_device->planes = NULL;
       impl_device->crtcs = NULL;
       impl_device->connectors = NULL;
-      return;
+      return changed;
     }
 
-  update_connectors (impl_device, drm_resources);
+  changed = update_connectors (impl_device, drm_resources);
+
+  for (l = impl_device->crtcs; l; l = l->next)
+    {
+      MetaKmsCrtc *crtc = l->data;
+
+      if (meta_kms_crtc_update_state (crtc))
+        changed = TRUE;
+    }
 
-  g_list_foreach (impl_device->crtcs, (GFunc) meta_kms_crtc_update_state,
-                  NULL);
-  g_list_foreach (impl_device->connectors, (GFunc) meta_kms_connector_update_state,
-                  drm_resources);
   drmModeFreeResources (drm_resources);
+
+  return changed;
 }
 
 void
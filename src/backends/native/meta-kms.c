@@ -454,17 +454,26 @@ meta_kms_is_waiting_for_impl_task (MetaKms *kms)
   return kms->waiting_for_impl_task;
 }
 
-static void
+static gboolean
 meta_kms_update_states_in_impl (MetaKms *kms)
 {
+  gboolean changed = FALSE;
+  GList *l;
+
   COGL_TRACE_BEGIN_SCOPED (MetaKmsUpdateStates,
                            "KMS (update states)");
 
   meta_assert_in_kms_impl (kms);
 
-  g_list_foreach (kms->devices,
-                  (GFunc) meta_kms_device_update_states_in_impl,
-                  NULL);
+  for (l = kms->devices; l; l = l->next)
+    {
+      MetaKmsDevice *device = l->data;
+
+      if (meta_kms_device_update_states_in_impl (device))
+        changed = TRUE;
+    }
+
+  return changed;
 }
 
 static gpointer
@@ -473,19 +482,22 @@ update_states_in_impl (MetaKmsImpl  *impl,
                        GError      **error)
 {
   MetaKms *kms = meta_kms_impl_get_kms (impl);
+  gboolean *changed = user_data;
 
-  meta_kms_update_states_in_impl (kms);
+  *changed = meta_kms_update_states_in_impl (kms);
 
   return GINT_TO_POINTER (TRUE);
 }
 
 static gboolean
-meta_kms_update_states_sync (MetaKms  *kms,
-                             GError  **error)
+meta_kms_update_states_sync (MetaKms   *kms,
+                             gboolean  *changed,
+                             GError   **error)
 {
   gpointer ret;
 
-  ret = meta_kms_run_impl_task_sync (kms, update_states_in_impl, NULL, error);
+  ret = meta_kms_run_impl_task_sync (kms, update_states_in_impl, changed,
+                                     error);
   return GPOINTER_TO_INT (ret);
 }
 
@@ -493,10 +505,19 @@ static void
 handle_hotplug_event (MetaKms *kms)
 {
   g_autoptr (GError) error = NULL;
+  gboolean changed = TRUE;
 
-  if (!meta_kms_update_states_sync (kms, &error))
+  if (!meta_kms_update_states_sync (kms, &changed, &error))
     g_warning ("Updating KMS state failed: %s", error->message);
 
+  /*
+   * Hotplug events are often emitted without anything visible to us having
+   * changed; avoid having the monitor manager re-read and rebuild everything
+   * in that case.
+   */
+  if (!changed)
+    return;
+
   g_signal_emit (kms, signals[RESOURCES_CHANGED], 0);
 }
 
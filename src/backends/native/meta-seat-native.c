@@ -231,29 +231,59 @@ dispatch_libinput (MetaSeatNative *seat)
   process_events (seat);
 }
 
+static gboolean keyboard_repeat (gpointer data);
+
+static void
+schedule_keyboard_repeat (MetaSeatNative *seat,
+                          uint32_t        interval)
+{
+  int64_t now_us;
+
+  /* Schedule relative to when the previous repeat was due rather than to
+   * when it got dispatched, so a busy main loop doesn't slow down the
+   * repeat rate. If we fell behind by more than an interval, don't try to
+   * catch up with a burst of repeats.
+   */
+  now_us = g_get_monotonic_time ();
+  seat->repeat_time += ms2us (interval);
+  if (seat->repeat_time < now_us)
+    seat->repeat_time = now_us;
+
+  seat->repeat_timer =
+    clutter_threads_add_timeout_full (CLUTTER_PRIORITY_EVENTS,
+                                      us2ms (seat->repeat_time - now_us),
+                                      keyboard_repeat,
+                                      seat,
+                                      NULL);
+}
+
 static gboolean
 keyboard_repeat (gpointer data)
 {
   MetaSeatNative *seat = data;
-  GSource *source;
+  guint source_id = g_source_get_id (g_main_current_source ());
 
-  /* There might be events queued in libinput that could cancel the
-     repeat timer. */
+  /* There might be events queued in libinput that could cancel or
+     restart the repeat timer. */
   dispatch_libinput (seat);
-  if (!seat->repeat_timer)
+  if (seat->repeat_timer != source_id)
     return G_SOURCE_REMOVE;
 
   g_return_val_if_fail (seat->repeat_device != NULL, G_SOURCE_REMOVE);
-  source = g_main_context_find_source_by_id (NULL, seat->repeat_timer);
 
   meta_seat_native_notify_key (seat,
                                seat->repeat_device,
-                               g_source_get_time (source),
+                               seat->repeat_time,
                                seat->repeat_key,
                                AUTOREPEAT_VALUE,
                                FALSE);
 
-  return G_SOURCE_CONTINUE;
+  /* The first repeat replaces the delay timer with an interval timer, any
+   * later one re-arms this one. */
+  if (seat->repeat_timer == source_id)
+    schedule_keyboard_repeat (seat, seat->repeat_interval);
+
+  return G_SOURCE_REMOVE;
 }
 
 static void
@@ -378,16 +408,16 @@ meta_seat_native_notify_key (MetaSeatNative     *seat,
         seat->repeat_device = g_object_ref (device);
 
         if (seat->repeat_count == 1)
-          interval = seat->repeat_delay;
+          {
+            interval = seat->repeat_delay;
+            seat->repeat_time = g_get_monotonic_time ();
+          }
         else
-          interval = seat->repeat_interval;
-
-        seat->repeat_timer =
-          clutter_threads_add_timeout_full (CLUTTER_PRIORITY_EVENTS,
-                                            interval,
-                                            keyboard_repeat,
-                                            seat,
-                                            NULL);
+          {
+            interval = seat->repeat_interval;
+          }
+
+        schedule_keyboard_repeat (seat, interval);
         return;
       }
     default:
@@ -395,6 +425,27 @@ meta_seat_native_notify_key (MetaSeatNative     *seat,
     }
 }
 
+/*
+ * The cursor is moved as soon as the motion has been translated and
+ * constrained, instead of when the stage gets around to processing the
+ * queued event on the next frame. This keeps a hardware cursor responsive
+ * even when the main loop is busy painting.
+ */
+static void
+update_cursor_position (float x,
+                        float y)
+{
+  MetaBackend *backend = meta_get_backend ();
+  MetaCursorTracker *cursor_tracker;
+
+  if (!backend)
+    return;
+
+  cursor_tracker = meta_backend_get_cursor_tracker (backend);
+  if (cursor_tracker)
+    meta_cursor_tracker_update_position (cursor_tracker, x, y);
+}
+
 static ClutterEvent *
 new_absolute_motion_event (MetaSeatNative     *seat,
                            ClutterInputDevice *input_device,
@@ -450,6 +501,8 @@ new_absolute_motion_event (MetaSeatNative     *seat,
     {
       seat->pointer_x = x;
       seat->pointer_y = y;
+
+      update_cursor_position (event->motion.x, event->motion.y);
     }
 
   return event;
@@ -879,14 +932,22 @@ meta_seat_native_notify_touch_event (MetaSeatNative     *seat,
 /*
  * MetaEventSource for reading input devices
  */
+static gboolean
+libinput_events_pending (MetaSeatNative *seat)
+{
+  return libinput_next_event_type (seat->libinput) != LIBINPUT_EVENT_NONE;
+}
+
 static gboolean
 meta_event_prepare (GSource *source,
                     gint    *timeout)
 {
+  MetaEventSource *event_source = (MetaEventSource *) source;
   gboolean retval;
 
   *timeout = -1;
-  retval = clutter_events_pending ();
+  retval = (clutter_events_pending () ||
+            libinput_events_pending (event_source->seat));
 
   return retval;
 }
@@ -898,7 +959,8 @@ meta_event_check (GSource *source)
   gboolean retval;
 
   retval = ((event_source->event_poll_fd.revents & G_IO_IN) ||
-            clutter_events_pending ());
+            clutter_events_pending () ||
+            libinput_events_pending (event_source->seat));
 
   return retval;
 }
@@ -1267,14 +1329,15 @@ meta_event_dispatch (GSource     *g_source,
 
   seat = source->seat;
 
-  /* Don't queue more events if we haven't finished handling the previous batch
+  /* Always drain the device fds, so the kernel buffers don't overflow and
+   * drop events while the main loop is busy, but don't queue more events if
+   * we haven't finished handling the previous batch. Whatever libinput
+   * queued up meanwhile is picked up once the batch is done.
    */
-  if (clutter_events_pending ())
-    goto queue_event;
-
-  dispatch_libinput (seat);
+  libinput_dispatch (seat->libinput);
+  if (!clutter_events_pending ())
+    process_events (seat);
 
- queue_event:
   event = clutter_event_get ();
 
   if (event)
@@ -2715,6 +2778,8 @@ meta_seat_native_compress_motion (ClutterSeat        *seat,
   double dst_dx = 0.0, dst_dy = 0.0;
   double dst_dx_unaccel = 0.0, dst_dy_unaccel = 0.0;
 
+  meta_event_native_add_motion_history (event, to_discard);
+
   if (!meta_event_native_get_relative_motion (to_discard,
                                               &dx, &dy,
                                               &dx_unaccel, &dy_unaccel))
@@ -2736,12 +2801,8 @@ meta_seat_native_warp_pointer (ClutterSeat *seat,
                                int          y)
 {
   MetaSeatNative *seat_native = META_SEAT_NATIVE (seat);
-  MetaBackend *backend = meta_get_backend ();
-  MetaCursorTracker *cursor_tracker = meta_backend_get_cursor_tracker (backend);
 
   notify_absolute_motion (seat_native->core_pointer, 0, x, y, NULL);
-
-  meta_cursor_tracker_update_position (cursor_tracker, x, y);
 }
 
 static void
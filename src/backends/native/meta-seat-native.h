@@ -131,6 +131,7 @@ struct _MetaSeatNative
   uint32_t repeat_key;
   uint32_t repeat_count;
   uint32_t repeat_timer;
+  int64_t repeat_time;
   ClutterInputDevice *repeat_device;
 
   float pointer_x;
@@ -21,6 +21,7 @@
 
 #include "compositor/meta-later-private.h"
 
+#include "clutter/clutter-mutter.h"
 #include "cogl/cogl.h"
 #include "compositor/compositor-private.h"
 #include "core/display-private.h"
@@ -38,17 +39,37 @@ typedef struct _MetaLater
 
   guint source_id;
   gboolean run_once;
+
+  /* The stage update this later was last run in */
+  unsigned int update_serial;
+
+  /* Link in the queue the later is in, if any; a later is in no queue
+   * while it is being invoked from a stage update. */
+  GList link;
+  GQueue *queue;
 } MetaLater;
 
 #define META_LATER_N_TYPES (META_LATER_IDLE + 1)
 
+/* Number of times the repaint laters are run again within one stage update
+ * to pick up laters that were added by earlier phases.
+ */
+#define MAX_REPAINT_LATER_PASSES 3
+
 struct _MetaLaters
 {
   MetaCompositor *compositor;
 
   unsigned int last_later_id;
+  unsigned int update_serial;
+
+  /* One queue per phase, most recently added first */
+  GQueue laters[META_LATER_N_TYPES];
+
+  /* The laters of the phase that is currently being run */
+  GQueue running_laters;
 
-  GSList *laters[META_LATER_N_TYPES];
+  GHashTable *laters_by_id;
 
   gulong before_update_handler_id;
 };
@@ -105,6 +126,28 @@ later_type_to_string (MetaLaterType when)
 
   return "unknown";
 }
+
+static const char *
+later_phase_to_string (MetaLaterType when)
+{
+  switch (when)
+    {
+    case META_LATER_RESIZE:
+      return "Laters phase (resize)";
+    case META_LATER_CALC_SHOWING:
+      return "Laters phase (calc-showing)";
+    case META_LATER_CHECK_FULLSCREEN:
+      return "Laters phase (check-fullscreen)";
+    case META_LATER_SYNC_STACK:
+      return "Laters phase (sync-stack)";
+    case META_LATER_BEFORE_REDRAW:
+      return "Laters phase (before-redraw)";
+    case META_LATER_IDLE:
+      return "Laters phase (idle)";
+    }
+
+  return "unknown";
+}
 #endif
 
 static gboolean
@@ -114,51 +157,89 @@ meta_later_invoke (MetaLater *later)
   return later->func (later->user_data);
 }
 
-static gboolean
-remove_later_from_list (unsigned int   later_id,
-                        GSList       **laters_list)
+static void
+meta_laters_remove_later (MetaLaters *laters,
+                          MetaLater  *later)
 {
-  GSList *l;
-
-  for (l = *laters_list; l; l = l->next)
+  if (later->queue)
     {
-      MetaLater *later = l->data;
-
-      if (later->id == later_id)
-        {
-          *laters_list = g_slist_delete_link (*laters_list, l);
-          meta_later_destroy (later);
-          return TRUE;
-        }
+      g_queue_unlink (later->queue, &later->link);
+      later->queue = NULL;
     }
 
-  return FALSE;
+  g_hash_table_remove (laters->laters_by_id, GUINT_TO_POINTER (later->id));
+  meta_later_destroy (later);
+}
+
+static gboolean
+should_run_repaint_later (MetaLater    *later,
+                          unsigned int  min_later_id,
+                          unsigned int  update_serial)
+{
+  if (later->id <= min_later_id ||
+      later->update_serial == update_serial)
+    return FALSE;
+
+  return (!later->source_id ||
+          (later->when <= META_LATER_BEFORE_REDRAW && !later->run_once));
 }
 
 static void
-run_repaint_laters (GSList **laters_list)
+run_repaint_laters (MetaLaters    *laters,
+                    MetaLaterType  when,
+                    unsigned int   min_later_id)
 {
-  g_autoptr (GSList) laters_copy = NULL;
-  GSList *l;
+  GQueue *queue = &laters->laters[when];
+  GQueue *running_laters = &laters->running_laters;
+  GList *link;
 
-  for (l = *laters_list; l; l = l->next)
-    {
-      MetaLater *later = l->data;
+  if (g_queue_is_empty (queue))
+    return;
 
-      if (!later->source_id ||
-          (later->when <= META_LATER_BEFORE_REDRAW && !later->run_once))
-        laters_copy = g_slist_prepend (laters_copy, meta_later_ref (later));
-    }
-  laters_copy = g_slist_reverse (laters_copy);
+  COGL_TRACE_BEGIN_SCOPED (RunLaters, later_phase_to_string (when));
+
+  /* Move the whole queue aside, so that laters added while running this
+   * phase end up in the phase queue and are not run in this pass. Laters
+   * that are kept are put back, in their original order, after those.
+   */
+  g_assert (g_queue_is_empty (running_laters));
+  *running_laters = *queue;
+  g_queue_init (queue);
+
+  for (link = running_laters->head; link; link = link->next)
+    ((MetaLater *) link->data)->queue = running_laters;
 
-  for (l = laters_copy; l; l = l->next)
+  while ((link = g_queue_pop_head_link (running_laters)))
     {
-      MetaLater *later = l->data;
+      MetaLater *later = link->data;
 
-      if (!later->func)
-        remove_later_from_list (later->id, laters_list);
-      else if (!meta_later_invoke (later))
-        remove_later_from_list (later->id, laters_list);
+      if (!should_run_repaint_later (later, min_later_id,
+                                     laters->update_serial))
+        {
+          g_queue_push_tail_link (queue, link);
+          later->queue = queue;
+          continue;
+        }
+
+      later->queue = NULL;
+      later->update_serial = laters->update_serial;
+
+      meta_later_ref (later);
+
+      /* The later may remove itself while being invoked */
+      if (!meta_later_invoke (later))
+        {
+          if (later->func)
+            meta_laters_remove_later (laters, later);
+        }
+      else if (later->func)
+        {
+          /* From now on, the later is run from stage updates only */
+          g_clear_handle_id (&later->source_id, g_source_remove);
+
+          g_queue_push_tail_link (queue, link);
+          later->queue = queue;
+        }
 
       meta_later_unref (later);
     }
@@ -170,20 +251,50 @@ on_before_update (ClutterStage     *stage,
                   MetaLaters       *laters)
 {
   unsigned int i;
-  GSList *l;
+  GList *l;
   gboolean needs_schedule_update = FALSE;
+  unsigned int min_later_id = 0;
+  unsigned int last_later_id;
+  int n_passes = 0;
 
-  for (i = 0; i < G_N_ELEMENTS (laters->laters); i++)
-    run_repaint_laters (&laters->laters[i]);
+  /* Laters added while running a phase (e.g. a window being queued for
+   * a move/resize while calculating which windows are showing) are run
+   * in another pass, so that their effects are part of this frame rather
+   * than the next one.
+   */
+  laters->update_serial++;
+
+  do
+    {
+      last_later_id = laters->last_later_id;
+
+      for (i = 0; i <= META_LATER_BEFORE_REDRAW; i++)
+        run_repaint_laters (laters, i, min_later_id);
+
+      min_later_id = last_later_id;
+      n_passes++;
+    }
+  while (laters->last_later_id != last_later_id &&
+         n_passes < MAX_REPAINT_LATER_PASSES);
 
   for (i = 0; i < G_N_ELEMENTS (laters->laters); i++)
     {
-      for (l = laters->laters[i]; l; l = l->next)
+      for (l = laters->laters[i].head; l; l = l->next)
         {
           MetaLater *later = l->data;
 
+          /* A resize later that keeps itself queued is run again with
+           * whatever frame comes next; it doesn't need one of its own.
+           */
+          if (later->when == META_LATER_RESIZE &&
+              later->update_serial == laters->update_serial)
+            continue;
+
           if (!later->source_id)
-            needs_schedule_update = TRUE;
+            {
+              needs_schedule_update = TRUE;
+              break;
+            }
         }
     }
 
@@ -208,6 +319,24 @@ invoke_later_idle (gpointer data)
     }
 }
 
+static gboolean
+will_frame_clock_dispatch (ClutterStage *stage)
+{
+  GList *l;
+
+  for (l = clutter_stage_peek_stage_views (stage); l; l = l->next)
+    {
+      ClutterStageView *view = l->data;
+      ClutterFrameClock *frame_clock =
+        clutter_stage_view_get_frame_clock (view);
+
+      if (!clutter_frame_clock_is_inhibited (frame_clock))
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
 static unsigned int
 meta_laters_add (MetaLaters     *laters,
                  MetaLaterType   when,
@@ -225,15 +354,27 @@ meta_laters_add (MetaLaters     *laters,
   later->user_data = user_data;
   later->destroy_notify = notify;
 
-  laters->laters[when] = g_slist_prepend (laters->laters[when], later);
+  later->link.data = later;
+  later->queue = &laters->laters[when];
+  g_queue_push_head_link (later->queue, &later->link);
+  g_hash_table_insert (laters->laters_by_id,
+                       GUINT_TO_POINTER (later->id), later);
 
   switch (when)
     {
     case META_LATER_RESIZE:
-      later->source_id = g_idle_add_full (META_PRIORITY_RESIZE,
-                                          invoke_later_idle,
-                                          later, NULL);
-      g_source_set_name_by_id (later->source_id, "[mutter] invoke_later_idle");
+      /* Resizes are run from the frame clock before painting; only fall
+       * back to an idle when there is no frame clock that would dispatch,
+       * e.g. with no stage views or all of them inhibited.
+       */
+      if (!will_frame_clock_dispatch (stage))
+        {
+          later->source_id = g_idle_add_full (META_PRIORITY_RESIZE,
+                                              invoke_later_idle,
+                                              later, NULL);
+          g_source_set_name_by_id (later->source_id,
+                                   "[mutter] invoke_later_idle");
+        }
       clutter_stage_schedule_update (stage);
       break;
     case META_LATER_CALC_SHOWING:
@@ -287,13 +428,14 @@ static void
 meta_laters_remove (MetaLaters   *laters,
                     unsigned int  later_id)
 {
-  unsigned int i;
+  MetaLater *later;
 
-  for (i = 0; i < G_N_ELEMENTS (laters->laters); i++)
-    {
-      if (remove_later_from_list (later_id, &laters->laters[i]))
-        return;
-    }
+  later = g_hash_table_lookup (laters->laters_by_id,
+                               GUINT_TO_POINTER (later_id));
+  if (!later)
+    return;
+
+  meta_laters_remove_later (laters, later);
 }
 
 /**
@@ -319,10 +461,17 @@ meta_laters_new (MetaCompositor *compositor)
 {
   ClutterStage *stage = meta_compositor_get_stage (compositor);
   MetaLaters *laters;
+  unsigned int i;
 
   laters = g_new0 (MetaLaters, 1);
   laters->compositor = compositor;
 
+  for (i = 0; i < G_N_ELEMENTS (laters->laters); i++)
+    g_queue_init (&laters->laters[i]);
+  g_queue_init (&laters->running_laters);
+
+  laters->laters_by_id = g_hash_table_new (NULL, NULL);
+
   laters->before_update_handler_id =
     g_signal_connect (stage, "before-update",
                       G_CALLBACK (on_before_update),
@@ -338,7 +487,14 @@ meta_laters_free (MetaLaters *laters)
   unsigned int i;
 
   for (i = 0; i < G_N_ELEMENTS (laters->laters); i++)
-    g_slist_free_full (laters->laters[i], (GDestroyNotify) meta_later_unref);
+    {
+      GList *link;
+
+      while ((link = g_queue_pop_head_link (&laters->laters[i])))
+        meta_later_unref (link->data);
+    }
+
+  g_hash_table_destroy (laters->laters_by_id);
 
   g_clear_signal_handler (&laters->before_update_handler_id, stage);
   g_free (laters);
@@ -72,11 +72,12 @@
  * no longer pending b) if necessary, drop the predicted stacking
  * order to recompute it at the next opportunity.
  *
- * Possible optimizations:
- *  Keep the stacks as an array + reverse-mapping hash table to avoid
- *    linear lookups.
- *  Keep the stacks as a GList + reverse-mapping hash table to avoid
- *    linear lookups and to make restacking constant-time.
+ * Both stacks are kept as an array of window IDs (which is what
+ * meta_stack_tracker_get_stack() hands out) plus a reverse mapping from
+ * window ID to position. Looking up a window is thus constant-time, and
+ * restacking a window only touches the entries between its old and new
+ * position. The mapping is only built once a stack is searched more than
+ * a few times, so recomputing the predicted stack stays a plain copy.
  */
 
 typedef union _MetaStackOp MetaStackOp;
@@ -141,6 +142,34 @@ union _MetaStackOp
   } lower_below;
 };
 
+typedef struct _MetaStackEntry
+{
+  guint64 window;
+  int pos;
+} MetaStackEntry;
+
+/* Number of lookups that are done by scanning the stack before an index
+ * is built for it; the predicted stack is rebuilt after most events and
+ * then usually only searched for a handful of windows.
+ */
+#define MAX_UNINDEXED_LOOKUPS 8
+
+typedef struct _MetaIndexedStack
+{
+  /* Window IDs, from bottom to top */
+  GArray *windows;
+
+  /* The index; NULL until it is built */
+
+  /* MetaStackEntry for each element in windows, in the same order */
+  GPtrArray *entries;
+
+  /* guint64 window => MetaStackEntry, keyed on the entry's window field */
+  GHashTable *positions;
+
+  guint n_lookups;
+} MetaIndexedStack;
+
 struct _MetaStackTracker
 {
   MetaDisplay *display;
@@ -152,7 +181,7 @@ struct _MetaStackTracker
 
   /* A combined stack containing X and Wayland windows but without
    * any unverified operations applied. */
-  GArray *verified_stack;
+  MetaIndexedStack *verified_stack;
 
   /* This is a queue of requests we've made to change the stacking order,
    * where we haven't yet gotten a reply back from the server.
@@ -163,7 +192,7 @@ struct _MetaStackTracker
    * on the unverified_predictions we've made subsequent to
    * verified_stack.
    */
-  GArray *predicted_stack;
+  MetaIndexedStack *predicted_stack;
 
   /* Idle function used to sync the compositor's view of the window
    * stack up with our best guess before a frame is drawn.
@@ -227,14 +256,14 @@ meta_stack_op_dump (MetaStackTracker *tracker,
 #ifdef WITH_VERBOSE_MODE
 static void
 stack_dump (MetaStackTracker *tracker,
-            GArray           *stack)
+            MetaIndexedStack *stack)
 {
   guint i;
 
   meta_push_no_msg_prefix ();
-  for (i = 0; i < stack->len; i++)
+  for (i = 0; i < stack->windows->len; i++)
     {
-      guint64 window = g_array_index (stack, guint64, i);
+      guint64 window = g_array_index (stack->windows, guint64, i);
       meta_topic (META_DEBUG_STACK, "  %s", get_window_desc (tracker, window));
     }
   meta_topic (META_DEBUG_STACK, "\n");
@@ -275,41 +304,218 @@ meta_stack_op_free (MetaStackOp *op)
   g_slice_free (MetaStackOp, op);
 }
 
-static int
-find_window (GArray  *window_stack,
-             guint64  window)
+static MetaStackEntry *
+meta_stack_entry_new (guint64 window,
+                      int     pos)
+{
+  MetaStackEntry *entry;
+
+  entry = g_slice_new (MetaStackEntry);
+  entry->window = window;
+  entry->pos = pos;
+
+  return entry;
+}
+
+static void
+meta_stack_entry_free (MetaStackEntry *entry)
+{
+  g_slice_free (MetaStackEntry, entry);
+}
+
+static MetaIndexedStack *
+indexed_stack_new (guint reserved_size)
+{
+  MetaIndexedStack *stack;
+
+  stack = g_new0 (MetaIndexedStack, 1);
+  stack->windows = g_array_sized_new (FALSE, FALSE, sizeof (guint64),
+                                      reserved_size);
+
+  return stack;
+}
+
+static void
+indexed_stack_free (MetaIndexedStack *stack)
+{
+  if (stack->entries)
+    {
+      g_hash_table_destroy (stack->positions);
+      g_ptr_array_free (stack->entries, TRUE);
+    }
+
+  g_array_free (stack->windows, TRUE);
+  g_free (stack);
+}
+
+static void
+indexed_stack_ensure_index (MetaIndexedStack *stack)
+{
+  guint n_windows = stack->windows->len;
+  guint i;
+
+  if (stack->entries)
+    return;
+
+  stack->entries =
+    g_ptr_array_new_full (n_windows,
+                          (GDestroyNotify) meta_stack_entry_free);
+  stack->positions = g_hash_table_new (g_int64_hash, g_int64_equal);
+
+  for (i = 0; i < n_windows; i++)
+    {
+      MetaStackEntry *entry;
+
+      entry = meta_stack_entry_new (g_array_index (stack->windows, guint64, i),
+                                    i);
+
+      g_ptr_array_add (stack->entries, entry);
+      g_hash_table_insert (stack->positions, &entry->window, entry);
+    }
+}
+
+static inline guint
+indexed_stack_get_length (MetaIndexedStack *stack)
+{
+  return stack->windows->len;
+}
+
+static inline guint64
+indexed_stack_get_window (MetaIndexedStack *stack,
+                          int               pos)
+{
+  return g_array_index (stack->windows, guint64, pos);
+}
+
+static inline MetaStackEntry *
+indexed_stack_get_entry (MetaIndexedStack *stack,
+                         int               pos)
+{
+  if (!stack->entries)
+    return NULL;
+
+  return g_ptr_array_index (stack->entries, pos);
+}
+
+static inline void
+indexed_stack_set_window (MetaIndexedStack *stack,
+                          int               pos,
+                          guint64           window,
+                          MetaStackEntry   *entry)
+{
+  g_array_index (stack->windows, guint64, pos) = window;
+
+  if (entry)
+    {
+      g_ptr_array_index (stack->entries, pos) = entry;
+      entry->pos = pos;
+    }
+}
+
+static void
+indexed_stack_append (MetaIndexedStack *stack,
+                      guint64           window)
+{
+  MetaStackEntry *entry;
+
+  if (stack->entries)
+    {
+      entry = meta_stack_entry_new (window, stack->windows->len);
+
+      g_ptr_array_add (stack->entries, entry);
+      g_hash_table_insert (stack->positions, &entry->window, entry);
+    }
+
+  g_array_append_val (stack->windows, window);
+}
+
+static void
+indexed_stack_remove_index (MetaIndexedStack *stack,
+                            int               pos)
 {
+  MetaStackEntry *entry;
   guint i;
 
-  for (i = 0; i < window_stack->len; i++)
+  g_array_remove_index (stack->windows, pos);
+
+  if (!stack->entries)
+    return;
+
+  entry = g_ptr_array_index (stack->entries, pos);
+  g_hash_table_remove (stack->positions, &entry->window);
+  g_ptr_array_remove_index (stack->entries, pos);
+
+  for (i = pos; i < stack->entries->len; i++)
     {
-      guint64 current = g_array_index (window_stack, guint64, i);
-      if (current == window)
-        return i;
+      entry = g_ptr_array_index (stack->entries, i);
+      entry->pos = i;
     }
+}
 
-  return -1;
+static MetaIndexedStack *
+copy_stack (MetaIndexedStack *stack)
+{
+  MetaIndexedStack *copy;
+
+  copy = indexed_stack_new (stack->windows->len);
+  g_array_append_vals (copy->windows,
+                       stack->windows->data, stack->windows->len);
+
+  return copy;
+}
+
+static int
+find_window (MetaIndexedStack *stack,
+             guint64           window)
+{
+  MetaStackEntry *entry;
+
+  if (!stack->entries && stack->n_lookups < MAX_UNINDEXED_LOOKUPS)
+    {
+      guint i;
+
+      stack->n_lookups++;
+
+      for (i = 0; i < stack->windows->len; i++)
+        {
+          if (indexed_stack_get_window (stack, i) == window)
+            return i;
+        }
+
+      return -1;
+    }
+
+  indexed_stack_ensure_index (stack);
+
+  entry = g_hash_table_lookup (stack->positions, &window);
+  if (!entry)
+    return -1;
+
+  return entry->pos;
 }
 
 /* Returns TRUE if stack was changed */
 static gboolean
-move_window_above (GArray    *stack,
-                   guint64    window,
-                   int        old_pos,
-                   int        above_pos,
-                   ApplyFlags apply_flags)
+move_window_above (MetaIndexedStack *stack,
+                   guint64           window,
+                   int               old_pos,
+                   int               above_pos,
+                   ApplyFlags        apply_flags)
 {
+  MetaStackEntry *entry;
   int i;
   gboolean can_restack_this_window =
     (apply_flags & NO_RESTACK_X_WINDOWS) == 0  || !META_STACK_ID_IS_X11 (window);
 
+  entry = indexed_stack_get_entry (stack, old_pos);
+
   if (old_pos < above_pos)
     {
       if ((apply_flags & IGNORE_NOOP_X_RESTACK) != 0)
         {
           gboolean found_x_window = FALSE;
           for (i = old_pos + 1; i <= above_pos; i++)
-            if (META_STACK_ID_IS_X11 (g_array_index (stack, guint64, i)))
+            if (META_STACK_ID_IS_X11 (indexed_stack_get_window (stack, i)))
               found_x_window = TRUE;
 
           if (!found_x_window)
@@ -319,14 +525,15 @@ move_window_above (GArray    *stack,
       for (i = old_pos; i < above_pos; i++)
         {
           if (!can_restack_this_window &&
-              META_STACK_ID_IS_X11 (g_array_index (stack, guint64, i + 1)))
+              META_STACK_ID_IS_X11 (indexed_stack_get_window (stack, i + 1)))
             break;
 
-          g_array_index (stack, guint64, i) =
-            g_array_index (stack, guint64, i + 1);
+          indexed_stack_set_window (stack, i,
+                                    indexed_stack_get_window (stack, i + 1),
+                                    indexed_stack_get_entry (stack, i + 1));
         }
 
-      g_array_index (stack, guint64, i) = window;
+      indexed_stack_set_window (stack, i, window, entry);
 
       return i != old_pos;
     }
@@ -336,7 +543,7 @@ move_window_above (GArray    *stack,
         {
           gboolean found_x_window = FALSE;
           for (i = above_pos + 1; i < old_pos; i++)
-            if (META_STACK_ID_IS_X11 (g_array_index (stack, guint64, i)))
+            if (META_STACK_ID_IS_X11 (indexed_stack_get_window (stack, i)))
               found_x_window = TRUE;
 
           if (!found_x_window)
@@ -346,14 +553,15 @@ move_window_above (GArray    *stack,
       for (i = old_pos; i > above_pos + 1; i--)
         {
           if (!can_restack_this_window &&
-              META_STACK_ID_IS_X11 (g_array_index (stack, guint64, i - 1)))
+              META_STACK_ID_IS_X11 (indexed_stack_get_window (stack, i - 1)))
             break;
 
-          g_array_index (stack, guint64, i) =
-            g_array_index (stack, guint64, i - 1);
+          indexed_stack_set_window (stack, i,
+                                    indexed_stack_get_window (stack, i - 1),
+                                    indexed_stack_get_entry (stack, i - 1));
         }
 
-      g_array_index (stack, guint64, i) = window;
+      indexed_stack_set_window (stack, i, window, entry);
 
       return i != old_pos;
     }
@@ -365,7 +573,7 @@ move_window_above (GArray    *stack,
 static gboolean
 meta_stack_op_apply (MetaStackTracker *tracker,
                      MetaStackOp      *op,
-                     GArray           *stack,
+                     MetaIndexedStack *stack,
                      ApplyFlags        apply_flags)
 {
   switch (op->any.type)
@@ -387,7 +595,7 @@ meta_stack_op_apply (MetaStackTracker *tracker,
             return FALSE;
           }
 
-        g_array_append_val (stack, op->add.window);
+        indexed_stack_append (stack, op->add.window);
         return TRUE;
       }
     case STACK_OP_REMOVE:
@@ -407,7 +615,7 @@ meta_stack_op_apply (MetaStackTracker *tracker,
             return FALSE;
           }
 
-        g_array_remove_index (stack, old_pos);
+        indexed_stack_remove_index (stack, old_pos);
         return TRUE;
       }
     case STACK_OP_RAISE_ABOVE:
@@ -474,7 +682,7 @@ meta_stack_op_apply (MetaStackTracker *tracker,
           }
         else
           {
-            above_pos = stack->len - 1;
+            above_pos = indexed_stack_get_length (stack) - 1;
           }
 
         return move_window_above (stack, op->lower_below.window, old_pos, above_pos,
@@ -486,18 +694,6 @@ meta_stack_op_apply (MetaStackTracker *tracker,
   return FALSE;
 }
 
-static GArray *
-copy_stack (GArray *stack)
-{
-  GArray *copy = g_array_sized_new (FALSE, FALSE, sizeof (guint64), stack->len);
-
-  g_array_set_size (copy, stack->len);
-
-  memcpy (copy->data, stack->data, sizeof (guint64) * stack->len);
-
-  return copy;
-}
-
 static void
 query_xserver_stack (MetaDisplay      *display,
                      MetaStackTracker *tracker)
@@ -506,7 +702,7 @@ query_xserver_stack (MetaDisplay      *display,
   Window ignored1, ignored2;
   Window *children;
   guint n_children;
-  guint i, old_len;
+  guint i;
 
   tracker->xserver_serial = XNextRequest (x11_display->xdisplay);
 
@@ -514,12 +710,8 @@ query_xserver_stack (MetaDisplay      *display,
               x11_display->xroot,
               &ignored1, &ignored2, &children, &n_children);
 
-  old_len = tracker->verified_stack->len;
-
-  g_array_set_size (tracker->verified_stack, old_len + n_children);
-
   for (i = 0; i < n_children; i++)
-    g_array_index (tracker->verified_stack, guint64, old_len + i) = children[i];
+    indexed_stack_append (tracker->verified_stack, children[i]);
 
   XFree (children);
 }
@@ -528,23 +720,23 @@ static void
 drop_x11_windows (MetaDisplay      *display,
                   MetaStackTracker *tracker)
 {
-  GArray *new_stack;
+  MetaIndexedStack *new_stack;
   GList *l;
-  int i;
+  guint i;
 
   tracker->xserver_serial = 0;
 
-  new_stack = g_array_new (FALSE, FALSE, sizeof (guint64));
+  new_stack = indexed_stack_new (0);
 
-  for (i = 0; i < tracker->verified_stack->len; i++)
+  for (i = 0; i < indexed_stack_get_length (tracker->verified_stack); i++)
     {
-      guint64 window = g_array_index (tracker->verified_stack, guint64, i);
+      guint64 window = indexed_stack_get_window (tracker->verified_stack, i);
 
       if (!META_STACK_ID_IS_X11 (window))
-        g_array_append_val (new_stack, window);
+        indexed_stack_append (new_stack, window);
     }
 
-  g_array_unref (tracker->verified_stack);
+  indexed_stack_free (tracker->verified_stack);
   tracker->verified_stack = new_stack;
   l = tracker->unverified_predictions->head;
 
@@ -568,7 +760,7 @@ meta_stack_tracker_new (MetaDisplay *display)
   tracker = g_new0 (MetaStackTracker, 1);
   tracker->display = display;
 
-  tracker->verified_stack = g_array_new (FALSE, FALSE, sizeof (guint64));
+  tracker->verified_stack = indexed_stack_new (0);
   tracker->unverified_predictions = g_queue_new ();
 
   g_signal_connect (display,
@@ -591,9 +783,9 @@ meta_stack_tracker_free (MetaStackTracker *tracker)
   if (tracker->sync_stack_later)
     meta_later_remove (tracker->sync_stack_later);
 
-  g_array_free (tracker->verified_stack, TRUE);
+  indexed_stack_free (tracker->verified_stack);
   if (tracker->predicted_stack)
-    g_array_free (tracker->predicted_stack, TRUE);
+    indexed_stack_free (tracker->predicted_stack);
 
   g_queue_foreach (tracker->unverified_predictions, (GFunc)meta_stack_op_free, NULL);
   g_queue_free (tracker->unverified_predictions);
@@ -671,7 +863,7 @@ meta_stack_tracker_record_remove (MetaStackTracker *tracker,
   stack_tracker_apply_prediction (tracker, op);
 }
 
-static void
+void
 meta_stack_tracker_record_raise_above (MetaStackTracker *tracker,
                                        guint64           window,
                                        guint64           sibling,
@@ -687,7 +879,7 @@ meta_stack_tracker_record_raise_above (MetaStackTracker *tracker,
   stack_tracker_apply_prediction (tracker, op);
 }
 
-static void
+void
 meta_stack_tracker_record_lower_below (MetaStackTracker *tracker,
                                        guint64           window,
                                        guint64           sibling,
@@ -768,7 +960,7 @@ stack_tracker_event_received (MetaStackTracker *tracker,
     {
       if (tracker->predicted_stack)
         {
-          g_array_free (tracker->predicted_stack, TRUE);
+          indexed_stack_free (tracker->predicted_stack);
           tracker->predicted_stack = NULL;
         }
 
@@ -856,6 +1048,27 @@ meta_stack_tracker_is_guard_window (MetaStackTracker *tracker,
   return stack_id == x11_display->guard_window;
 }
 
+static MetaIndexedStack *
+get_current_stack (MetaStackTracker *tracker)
+{
+  if (tracker->unverified_predictions->length == 0)
+    return tracker->verified_stack;
+
+  if (tracker->predicted_stack == NULL)
+    {
+      GList *l;
+
+      tracker->predicted_stack = copy_stack (tracker->verified_stack);
+      for (l = tracker->unverified_predictions->head; l; l = l->next)
+        {
+          MetaStackOp *op = l->data;
+          meta_stack_op_apply (tracker, op, tracker->predicted_stack, APPLY_DEFAULT);
+        }
+    }
+
+  return tracker->predicted_stack;
+}
+
 /**
  * meta_stack_tracker_get_stack:
  * @tracker: a #MetaStackTracker
@@ -878,33 +1091,14 @@ meta_stack_tracker_get_stack (MetaStackTracker *tracker,
                               guint64         **windows,
 			      int              *n_windows)
 {
-  GArray *stack;
-
-  if (tracker->unverified_predictions->length == 0)
-    {
-      stack = tracker->verified_stack;
-    }
-  else
-    {
-      if (tracker->predicted_stack == NULL)
-        {
-          GList *l;
-
-          tracker->predicted_stack = copy_stack (tracker->verified_stack);
-          for (l = tracker->unverified_predictions->head; l; l = l->next)
-            {
-              MetaStackOp *op = l->data;
-              meta_stack_op_apply (tracker, op, tracker->predicted_stack, APPLY_DEFAULT);
-            }
-        }
+  MetaIndexedStack *stack;
 
-      stack = tracker->predicted_stack;
-    }
+  stack = get_current_stack (tracker);
 
   if (windows)
-    *windows = (guint64 *)stack->data;
+    *windows = (guint64 *) stack->windows->data;
   if (n_windows)
-    *n_windows = stack->len;
+    *n_windows = stack->windows->len;
 }
 
 /**
@@ -1010,28 +1204,24 @@ static Window
 find_x11_sibling_downwards (MetaStackTracker *tracker,
                             guint64           sibling)
 {
-  guint64 *windows;
-  int n_windows;
+  MetaIndexedStack *stack;
   int i;
 
   if (META_STACK_ID_IS_X11 (sibling))
     return (Window)sibling;
 
-  meta_stack_tracker_get_stack (tracker,
-                                &windows, &n_windows);
+  stack = get_current_stack (tracker);
 
   /* NB: Children are in order from bottom to top and we
    * want to search downwards for the nearest X window.
    */
 
-  for (i = n_windows - 1; i >= 0; i--)
-    if (windows[i] == sibling)
-      break;
-
-  for (; i >= 0; i--)
+  for (i = find_window (stack, sibling); i >= 0; i--)
     {
-      if (META_STACK_ID_IS_X11 (windows[i]))
-        return (Window)windows[i];
+      guint64 window = indexed_stack_get_window (stack, i);
+
+      if (META_STACK_ID_IS_X11 (window))
+        return (Window)window;
     }
 
   return None;
@@ -1041,24 +1231,26 @@ static Window
 find_x11_sibling_upwards (MetaStackTracker *tracker,
                           guint64           sibling)
 {
-  guint64 *windows;
+  MetaIndexedStack *stack;
   int n_windows;
   int i;
 
   if (META_STACK_ID_IS_X11 (sibling))
     return (Window)sibling;
 
-  meta_stack_tracker_get_stack (tracker,
-                                &windows, &n_windows);
+  stack = get_current_stack (tracker);
+  n_windows = indexed_stack_get_length (stack);
 
-  for (i = 0; i < n_windows; i++)
-    if (windows[i] == sibling)
-      break;
+  i = find_window (stack, sibling);
+  if (i < 0)
+    return None;
 
   for (; i < n_windows; i++)
     {
-      if (META_STACK_ID_IS_X11 (windows[i]))
-        return (Window)windows[i];
+      guint64 window = indexed_stack_get_window (stack, i);
+
+      if (META_STACK_ID_IS_X11 (window))
+        return (Window)window;
     }
 
   return None;
@@ -40,18 +40,32 @@
 
 typedef struct _MetaStackTracker MetaStackTracker;
 
+META_EXPORT_TEST
 MetaStackTracker *meta_stack_tracker_new  (MetaDisplay      *display);
+META_EXPORT_TEST
 void              meta_stack_tracker_free (MetaStackTracker *tracker);
 
 /* These functions are called when we make an X call that changes the
  * stacking order; this allows MetaStackTracker to predict stacking
  * order before it receives events back from the X server */
+META_EXPORT_TEST
 void meta_stack_tracker_record_add             (MetaStackTracker *tracker,
                                                 guint64           window,
                                                 gulong            serial);
+META_EXPORT_TEST
 void meta_stack_tracker_record_remove          (MetaStackTracker *tracker,
                                                 guint64           window,
                                                 gulong            serial);
+META_EXPORT_TEST
+void meta_stack_tracker_record_raise_above     (MetaStackTracker *tracker,
+                                                guint64           window,
+                                                guint64           sibling,
+                                                gulong            serial);
+META_EXPORT_TEST
+void meta_stack_tracker_record_lower_below     (MetaStackTracker *tracker,
+                                                guint64           window,
+                                                guint64           sibling,
+                                                gulong            serial);
 
 /* We also have functions that also go ahead and do the work
  */
@@ -67,12 +81,15 @@ void meta_stack_tracker_restack_at_bottom (MetaStackTracker *tracker,
 
 /* These functions are used to update the stack when we get events
  * reflecting changes to the stacking order */
+META_EXPORT_TEST
 void meta_stack_tracker_create_event    (MetaStackTracker    *tracker,
 					 XCreateWindowEvent  *event);
+META_EXPORT_TEST
 void meta_stack_tracker_destroy_event   (MetaStackTracker    *tracker,
 					 XDestroyWindowEvent *event);
 void meta_stack_tracker_reparent_event  (MetaStackTracker    *tracker,
 					 XReparentEvent      *event);
+META_EXPORT_TEST
 void meta_stack_tracker_configure_event (MetaStackTracker    *tracker,
 					 XConfigureEvent     *event);
 
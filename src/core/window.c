@@ -5426,6 +5426,17 @@ meta_window_update_icon_now (MetaWindow *window,
 
   changed = META_WINDOW_GET_CLASS (window)->update_icon (window, &icon, &mini_icon);
 
+  /* Icons may be shared between windows and reused when the client sets
+   * the same icon again; don't notify if nothing actually changed.
+   */
+  if (changed && !force &&
+      icon == window->icon && mini_icon == window->mini_icon)
+    {
+      g_clear_pointer (&icon, cairo_surface_destroy);
+      g_clear_pointer (&mini_icon, cairo_surface_destroy);
+      return;
+    }
+
   if (changed || force)
     {
       if (window->icon)
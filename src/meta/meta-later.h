@@ -23,7 +23,8 @@
 /**
  * MetaLaterType:
  * @META_LATER_RESIZE: call in a resize processing phase that is done
- *   before GTK+ repainting (including window borders) is done.
+ *   before GTK+ repainting (including window borders) is done. This is
+ *   the first phase run before each stage update.
  * @META_LATER_CALC_SHOWING: used by Mutter to compute which windows should be mapped
  * @META_LATER_CHECK_FULLSCREEN: used by Mutter to see if there's a fullscreen window
  * @META_LATER_SYNC_STACK: used by Mutter to send it's idea of the stacking order to the server
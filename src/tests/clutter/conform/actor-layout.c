@@ -92,7 +92,91 @@ actor_margin_layout (void)
   clutter_actor_destroy (vase);
 }
 
+static void
+on_queue_relayout (ClutterActor *actor,
+                   int          *n_relayouts)
+{
+  *n_relayouts += 1;
+}
+
+static void
+actor_relayout_boundary (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *vase;
+  ClutterActor *frame;
+  ClutterActor *flower;
+  ClutterActor *leaf;
+  const ClutterPaintVolume *pv;
+  ClutterActorBox box;
+  int n_relayouts = 0;
+
+  vase = clutter_actor_new ();
+  clutter_actor_set_name (vase, "Vase");
+  clutter_actor_set_layout_manager (vase, clutter_box_layout_new ());
+  clutter_actor_add_child (stage, vase);
+
+  frame = clutter_actor_new ();
+  clutter_actor_set_size (frame, 100, 100);
+  clutter_actor_set_name (frame, "Frame");
+  clutter_actor_add_child (vase, frame);
+
+  flower = clutter_actor_new ();
+  clutter_actor_set_size (flower, 50, 50);
+  clutter_actor_set_name (flower, "Flower");
+  clutter_actor_add_child (frame, flower);
+
+  leaf = clutter_actor_new ();
+  clutter_actor_set_size (leaf, 100, 100);
+  clutter_actor_set_name (leaf, "Leaf");
+  clutter_actor_add_child (vase, leaf);
+
+  clutter_actor_show (stage);
+  clutter_actor_get_allocation_box (leaf, &box);
+  g_assert_cmpfloat (box.x1, ==, 100);
+
+  g_signal_connect (vase, "queue-relayout",
+                    G_CALLBACK (on_queue_relayout), &n_relayouts);
+
+  /* The frame has a fixed size, so what happens inside of it doesn't
+   * concern the vase
+   */
+  clutter_actor_set_size (flower, 80, 80);
+  g_assert_cmpint (n_relayouts, ==, 0);
+
+  clutter_actor_get_allocation_box (flower, &box);
+  g_assert_cmpfloat (clutter_actor_box_get_width (&box), ==, 80);
+  g_assert_cmpfloat (clutter_actor_box_get_height (&box), ==, 80);
+
+  pv = clutter_actor_get_paint_volume (vase);
+  g_assert_nonnull (pv);
+  g_assert_cmpfloat (clutter_paint_volume_get_width (pv), ==, 200);
+
+  /* The vase still has to account for the flower overflowing the frame
+   * when painting, even if it doesn't have to lay it out
+   */
+  clutter_actor_set_position (flower, 250, 0);
+  g_assert_cmpint (n_relayouts, ==, 0);
+
+  clutter_actor_get_allocation_box (flower, &box);
+  g_assert_cmpfloat (box.x1, ==, 250);
+
+  pv = clutter_actor_get_paint_volume (vase);
+  g_assert_nonnull (pv);
+  g_assert_cmpfloat (clutter_paint_volume_get_width (pv), ==, 330);
+
+  /* ...unlike resizing the frame itself */
+  clutter_actor_set_width (frame, 150);
+  g_assert_cmpint (n_relayouts, >, 0);
+
+  clutter_actor_get_allocation_box (leaf, &box);
+  g_assert_cmpfloat (box.x1, ==, 150);
+
+  clutter_actor_destroy (vase);
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/actor/layout/basic", actor_basic_layout)
   CLUTTER_TEST_UNIT ("/actor/layout/margin", actor_margin_layout)
+  CLUTTER_TEST_UNIT ("/actor/layout/relayout-boundary", actor_relayout_boundary)
 )
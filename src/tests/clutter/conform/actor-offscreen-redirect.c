@@ -210,6 +210,14 @@ verify_redraws (gpointer user_data)
   clutter_actor_set_translation (data->parent_container, 0.f, -1.f, 0.f);
   verify_redraw (data, 0);
 
+  /* The same goes for modifying the transformation of the redirected
+     actor itself. */
+  clutter_actor_set_translation (data->container, 0.f, -1.f, 0.f);
+  verify_redraw (data, 0);
+
+  clutter_actor_set_scale (data->container, 0.5, 0.5);
+  verify_redraw (data, 0);
+
   /* Redrawing an unrelated actor shouldn't cause a redraw */
   clutter_actor_set_position (data->unrelated_actor, 0, 1);
   verify_redraw (data, 0);
@@ -226,6 +226,85 @@ actor_pick (void)
   g_list_free_full (state.actor_list, (GDestroyNotify) clutter_actor_destroy);
 }
 
+static void
+on_presented (ClutterStage     *stage,
+              ClutterStageView *view,
+              ClutterFrameInfo *frame_info,
+              gboolean         *was_presented)
+{
+  *was_presented = TRUE;
+}
+
+static void
+actor_pick_culled (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterActor *actor;
+  ClutterActor *container;
+  ClutterActor *child;
+  ClutterActorBox box;
+  gboolean was_presented;
+  gulong presented_id;
+
+  actor = clutter_actor_new ();
+  clutter_actor_set_reactive (actor, TRUE);
+  clutter_actor_set_size (actor, 100, 100);
+  clutter_actor_set_position (actor, -200, 0);
+  clutter_actor_add_child (stage, actor);
+
+  container = clutter_actor_new ();
+  clutter_actor_set_size (container, 100, 100);
+  clutter_actor_set_position (container, -200, 200);
+  clutter_actor_add_child (stage, container);
+
+  child = clutter_actor_new ();
+  clutter_actor_set_reactive (child, TRUE);
+  clutter_actor_set_size (child, 50, 50);
+  clutter_actor_add_child (container, child);
+
+  presented_id = g_signal_connect (stage, "presented",
+                                   G_CALLBACK (on_presented),
+                                   &was_presented);
+
+  clutter_actor_show (stage);
+
+  was_presented = FALSE;
+  while (!was_presented)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert (clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
+                                            CLUTTER_PICK_REACTIVE,
+                                            50, 50) == stage);
+  g_assert (clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
+                                            CLUTTER_PICK_REACTIVE,
+                                            75, 225) == stage);
+
+  /* The actor is outside of the view when it was last painted, but
+   * moving it in makes it pickable without painting it first
+   */
+  clutter_actor_set_position (actor, 0, 0);
+  clutter_actor_get_allocation_box (actor, &box);
+
+  g_assert (clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
+                                            CLUTTER_PICK_REACTIVE,
+                                            50, 50) == actor);
+
+  /* The same goes for a child moved out of a container that stays
+   * outside of the view
+   */
+  clutter_actor_set_position (child, 250, 0);
+  clutter_actor_get_allocation_box (child, &box);
+
+  g_assert (clutter_stage_get_actor_at_pos (CLUTTER_STAGE (stage),
+                                            CLUTTER_PICK_REACTIVE,
+                                            75, 225) == child);
+
+  g_signal_handler_disconnect (stage, presented_id);
+  clutter_actor_destroy (container);
+  clutter_actor_destroy (actor);
+}
+
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/actor/pick", actor_pick)
+  CLUTTER_TEST_UNIT ("/actor/pick/culled", actor_pick_culled)
 )
@@ -0,0 +1,169 @@
+#include <clutter/clutter.h>
+
+#include "tests/clutter-test-utils.h"
+
+typedef struct _TransitionTestData
+{
+  ClutterActor *actor;
+  GMainLoop *main_loop;
+
+  int n_opacity_frames;
+  int n_opacity_notifies;
+  int n_color_frames;
+  int n_color_notifies;
+  int n_x_frames;
+  int n_completed;
+} TransitionTestData;
+
+static const GValue *
+compute_expected_value (ClutterTimeline *timeline)
+{
+  ClutterInterval *interval;
+
+  interval = clutter_transition_get_interval (CLUTTER_TRANSITION (timeline));
+
+  return clutter_interval_compute (interval,
+                                   clutter_timeline_get_progress (timeline));
+}
+
+static void
+on_opacity_new_frame (ClutterTimeline    *timeline,
+                      int                 elapsed_msecs,
+                      TransitionTestData *data)
+{
+  const GValue *expected = compute_expected_value (timeline);
+
+  g_assert_cmpuint (clutter_actor_get_opacity (data->actor),
+                    ==,
+                    g_value_get_uint (expected));
+
+  data->n_opacity_frames++;
+}
+
+static void
+on_color_new_frame (ClutterTimeline    *timeline,
+                    int                 elapsed_msecs,
+                    TransitionTestData *data)
+{
+  const GValue *expected = compute_expected_value (timeline);
+  ClutterColor color;
+
+  clutter_actor_get_background_color (data->actor, &color);
+  g_assert_true (clutter_color_equal (&color, g_value_get_boxed (expected)));
+
+  data->n_color_frames++;
+}
+
+static void
+on_x_new_frame (ClutterTimeline    *timeline,
+                int                 elapsed_msecs,
+                TransitionTestData *data)
+{
+  const GValue *expected = compute_expected_value (timeline);
+  float x;
+
+  g_object_get (data->actor, "fixed-x", &x, NULL);
+  g_assert_cmpfloat (x, ==, g_value_get_float (expected));
+
+  data->n_x_frames++;
+}
+
+static void
+on_opacity_notify (ClutterActor       *actor,
+                   GParamSpec         *pspec,
+                   TransitionTestData *data)
+{
+  /* Notifications are held back until all timelines of the frame have
+   * been advanced, and then emitted once.
+   */
+  data->n_opacity_notifies++;
+  g_assert_cmpint (data->n_opacity_notifies, ==, data->n_opacity_frames);
+}
+
+static void
+on_color_notify (ClutterActor       *actor,
+                 GParamSpec         *pspec,
+                 TransitionTestData *data)
+{
+  data->n_color_notifies++;
+  g_assert_cmpint (data->n_color_notifies, ==, data->n_color_frames);
+}
+
+static void
+on_completed (ClutterTimeline    *timeline,
+              TransitionTestData *data)
+{
+  if (++data->n_completed == 3)
+    g_main_loop_quit (data->main_loop);
+}
+
+static void
+add_transition (TransitionTestData *data,
+                const char         *property_name,
+                ClutterTransition  *transition,
+                GCallback           new_frame_cb)
+{
+  clutter_timeline_set_duration (CLUTTER_TIMELINE (transition), 250);
+
+  g_signal_connect_after (transition, "new-frame", new_frame_cb, data);
+  g_signal_connect (transition, "completed", G_CALLBACK (on_completed), data);
+
+  clutter_actor_add_transition (data->actor, property_name, transition);
+  g_object_unref (transition);
+}
+
+static void
+actor_property_transition_interpolate (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  TransitionTestData data = { 0 };
+  ClutterColor from_color = { 255, 0, 0, 255 };
+  ClutterColor to_color = { 0, 64, 255, 128 };
+  ClutterTransition *transition;
+
+  data.actor = clutter_actor_new ();
+  clutter_actor_set_size (data.actor, 100, 100);
+  clutter_actor_add_child (stage, data.actor);
+  clutter_actor_show (stage);
+
+  data.main_loop = g_main_loop_new (NULL, FALSE);
+
+  g_signal_connect (data.actor, "notify::opacity",
+                    G_CALLBACK (on_opacity_notify), &data);
+  g_signal_connect (data.actor, "notify::background-color",
+                    G_CALLBACK (on_color_notify), &data);
+
+  transition = clutter_property_transition_new ("opacity");
+  clutter_transition_set_from (transition, G_TYPE_UINT, 0);
+  clutter_transition_set_to (transition, G_TYPE_UINT, 255);
+  add_transition (&data, "opacity", transition,
+                  G_CALLBACK (on_opacity_new_frame));
+
+  transition = clutter_property_transition_new ("background-color");
+  clutter_transition_set_from (transition, CLUTTER_TYPE_COLOR, &from_color);
+  clutter_transition_set_to (transition, CLUTTER_TYPE_COLOR, &to_color);
+  add_transition (&data, "background-color", transition,
+                  G_CALLBACK (on_color_new_frame));
+
+  transition = clutter_property_transition_new ("x");
+  clutter_transition_set_from (transition, G_TYPE_FLOAT, 0.f);
+  clutter_transition_set_to (transition, G_TYPE_FLOAT, 100.f);
+  add_transition (&data, "x", transition, G_CALLBACK (on_x_new_frame));
+
+  g_main_loop_run (data.main_loop);
+
+  g_assert_cmpint (data.n_opacity_frames, >, 1);
+  g_assert_cmpint (data.n_opacity_notifies, ==, data.n_opacity_frames);
+  g_assert_cmpint (data.n_color_frames, >, 1);
+  g_assert_cmpint (data.n_color_notifies, ==, data.n_color_frames);
+  g_assert_cmpint (data.n_x_frames, >, 1);
+
+  g_assert_cmpuint (clutter_actor_get_opacity (data.actor), ==, 255);
+
+  g_main_loop_unref (data.main_loop);
+  clutter_actor_destroy (data.actor);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/actor/transition/interpolate", actor_property_transition_interpolate)
+)
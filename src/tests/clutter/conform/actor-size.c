@@ -140,6 +140,47 @@ actor_preferred_size (void)
   clutter_actor_destroy (test);
 }
 
+static void
+actor_size_request_cache (void)
+{
+  ClutterActor *test;
+  TestActor *self;
+  gfloat min_width, nat_width;
+  int i;
+
+  test = g_object_new (TEST_TYPE_ACTOR, NULL);
+  self = (TestActor *) test;
+
+  for (i = 1; i <= 8; i++)
+    {
+      self->preferred_width_called = FALSE;
+      clutter_actor_get_preferred_width (test, i * 10, &min_width, &nat_width);
+      g_assert (self->preferred_width_called);
+    }
+
+  /* More sizes than fit in the small per-actor cache are remembered */
+  for (i = 1; i <= 8; i++)
+    {
+      self->preferred_width_called = FALSE;
+      clutter_actor_get_preferred_width (test, i * 10, &min_width, &nat_width);
+      g_assert (!self->preferred_width_called);
+      g_assert_cmpfloat (min_width, ==, i == 1 ? 10 : 100);
+    }
+
+  /* Moving the actor doesn't change its size requests */
+  clutter_actor_set_position (test, 20, 30);
+  clutter_actor_get_preferred_width (test, 10, &min_width, &nat_width);
+  g_assert (!self->preferred_width_called);
+
+  /* But anything else queueing a relayout does */
+  clutter_actor_queue_relayout (test);
+  clutter_actor_get_preferred_width (test, 10, &min_width, &nat_width);
+  g_assert (self->preferred_width_called);
+  g_assert_cmpfloat (min_width, ==, 10);
+
+  clutter_actor_destroy (test);
+}
+
 static void
 actor_fixed_size (void)
 {
@@ -214,5 +255,6 @@ actor_fixed_size (void)
 
 CLUTTER_TEST_SUITE (
   CLUTTER_TEST_UNIT ("/actor/size/preferred", actor_preferred_size)
+  CLUTTER_TEST_UNIT ("/actor/size/cache", actor_size_request_cache)
   CLUTTER_TEST_UNIT ("/actor/size/fixed", actor_fixed_size)
 )
@@ -0,0 +1,334 @@
+#include <clutter/clutter.h>
+
+#include <string.h>
+
+#include "clutter/clutter-damage-tiles.h"
+#include "tests/clutter-test-utils.h"
+
+#define BPP 4
+#define N_ROUNDS 20
+
+typedef struct _TestBuffers
+{
+  int width;
+  int height;
+  int stride;
+
+  uint8_t *prev_data;
+  uint8_t *current_data;
+} TestBuffers;
+
+static void
+test_buffers_init (TestBuffers *buffers,
+                   int          width,
+                   int          height,
+                   int          stride_padding)
+{
+  size_t size;
+  size_t i;
+
+  buffers->width = width;
+  buffers->height = height;
+  buffers->stride = width * BPP + stride_padding;
+
+  size = (size_t) buffers->stride * height;
+  buffers->prev_data = g_malloc (size);
+  buffers->current_data = g_malloc (size);
+
+  for (i = 0; i < size; i++)
+    buffers->prev_data[i] = g_test_rand_int_range (0, 256);
+}
+
+static void
+test_buffers_clear (TestBuffers *buffers)
+{
+  g_clear_pointer (&buffers->prev_data, g_free);
+  g_clear_pointer (&buffers->current_data, g_free);
+}
+
+static void
+change_pixel (TestBuffers *buffers,
+              int          x,
+              int          y)
+{
+  size_t offset = (size_t) y * buffers->stride + x * BPP;
+
+  buffers->current_data[offset + g_test_rand_int_range (0, BPP)] ^= 0x80;
+}
+
+static void
+randomize_changes (TestBuffers *buffers)
+{
+  int n_changes;
+  int i;
+
+  memcpy (buffers->current_data, buffers->prev_data,
+          (size_t) buffers->stride * buffers->height);
+
+  n_changes = g_test_rand_int_range (0, 64);
+  for (i = 0; i < n_changes; i++)
+    {
+      change_pixel (buffers,
+                    g_test_rand_int_range (0, buffers->width),
+                    g_test_rand_int_range (0, buffers->height));
+    }
+
+  /* Short horizontal runs, to end up with neighbouring dirty tiles */
+  n_changes = g_test_rand_int_range (0, 4);
+  for (i = 0; i < n_changes; i++)
+    {
+      int y = g_test_rand_int_range (0, buffers->height);
+      int x;
+
+      for (x = g_test_rand_int_range (0, buffers->width);
+           x < buffers->width;
+           x += g_test_rand_int_range (8, 48))
+        change_pixel (buffers, x, y);
+    }
+
+  /* Pixels in the partial tiles at the right and bottom edges */
+  if (g_test_rand_bit ())
+    {
+      change_pixel (buffers,
+                    buffers->width - 1,
+                    g_test_rand_int_range (0, buffers->height));
+    }
+  if (g_test_rand_bit ())
+    {
+      change_pixel (buffers,
+                    g_test_rand_int_range (0, buffers->width),
+                    buffers->height - 1);
+    }
+
+  /* The padding at the end of each row is never looked at */
+  if (buffers->stride > buffers->width * BPP)
+    {
+      int y = g_test_rand_int_range (0, buffers->height);
+      size_t offset = (size_t) y * buffers->stride + buffers->width * BPP;
+
+      buffers->current_data[offset] ^= 0x80;
+    }
+}
+
+static int
+get_expected_tile_size (TestBuffers          *buffers,
+                        const cairo_region_t *damage_region)
+{
+  cairo_rectangle_int_t extents;
+
+  /* Mirrors the tile size heuristic of clutter_damage_tiles_find() */
+  cairo_region_get_extents (damage_region, &extents);
+  if ((int64_t) extents.width * extents.height >
+      (int64_t) buffers->width * buffers->height / 4)
+    return 32;
+  else
+    return 16;
+}
+
+static cairo_region_t *
+find_reference_damage (TestBuffers          *buffers,
+                       const cairo_region_t *damage_region,
+                       int                   tile_size)
+{
+  cairo_region_t *region;
+  int x, y;
+
+  region = cairo_region_create ();
+
+  for (y = 0; y < buffers->height; y += tile_size)
+    {
+      for (x = 0; x < buffers->width; x += tile_size)
+        {
+          cairo_rectangle_int_t tile = {
+            .x = x,
+            .y = y,
+            .width = tile_size,
+            .height = tile_size,
+          };
+          int row;
+
+          if (cairo_region_contains_rectangle (damage_region, &tile) ==
+              CAIRO_REGION_OVERLAP_OUT)
+            continue;
+
+          tile.width = MIN (tile_size, buffers->width - x);
+          tile.height = MIN (tile_size, buffers->height - y);
+
+          for (row = y; row < y + tile.height; row++)
+            {
+              size_t offset = (size_t) row * buffers->stride + x * BPP;
+
+              if (memcmp (buffers->prev_data + offset,
+                          buffers->current_data + offset,
+                          tile.width * BPP) != 0)
+                {
+                  cairo_region_union_rectangle (region, &tile);
+                  break;
+                }
+            }
+        }
+    }
+
+  cairo_region_intersect (region, damage_region);
+
+  return region;
+}
+
+static void
+assert_damage_matches_reference (TestBuffers          *buffers,
+                                 const cairo_region_t *damage_region,
+                                 int                   expected_tile_size)
+{
+  cairo_region_t *region;
+  cairo_region_t *reference_region;
+  int tile_size;
+
+  tile_size = get_expected_tile_size (buffers, damage_region);
+  g_assert_cmpint (tile_size, ==, expected_tile_size);
+
+  region = clutter_damage_tiles_find (damage_region,
+                                      buffers->current_data,
+                                      buffers->prev_data,
+                                      buffers->width,
+                                      buffers->height,
+                                      buffers->stride,
+                                      BPP);
+  reference_region = find_reference_damage (buffers, damage_region,
+                                             tile_size);
+
+  g_assert_true (cairo_region_equal (region, reference_region));
+
+  cairo_region_destroy (reference_region);
+  cairo_region_destroy (region);
+}
+
+static cairo_region_t *
+create_random_damage (int x,
+                      int y,
+                      int width,
+                      int height,
+                      int max_rect_size)
+{
+  cairo_region_t *damage_region;
+  int n_rects;
+  int i;
+
+  damage_region = cairo_region_create ();
+
+  n_rects = g_test_rand_int_range (1, 8);
+  for (i = 0; i < n_rects; i++)
+    {
+      cairo_rectangle_int_t rect;
+
+      rect.x = x + g_test_rand_int_range (0, width);
+      rect.y = y + g_test_rand_int_range (0, height);
+      rect.width = MIN (g_test_rand_int_range (1, max_rect_size),
+                        x + width - rect.x);
+      rect.height = MIN (g_test_rand_int_range (1, max_rect_size),
+                         y + height - rect.y);
+      cairo_region_union_rectangle (damage_region, &rect);
+    }
+
+  return damage_region;
+}
+
+static void
+damage_tiles_small_damage (void)
+{
+  TestBuffers buffers;
+  int i;
+
+  test_buffers_init (&buffers, 643, 487, 12);
+
+  for (i = 0; i < N_ROUNDS; i++)
+    {
+      cairo_region_t *damage_region;
+      int x, y;
+
+      /* Keep the damage within a small window to get small tiles */
+      x = g_test_rand_int_range (0, buffers.width - 200);
+      y = g_test_rand_int_range (0, buffers.height - 150);
+      damage_region = create_random_damage (x, y, 200, 150, 64);
+
+      randomize_changes (&buffers);
+      assert_damage_matches_reference (&buffers, damage_region, 16);
+
+      cairo_region_destroy (damage_region);
+    }
+
+  test_buffers_clear (&buffers);
+}
+
+static void
+damage_tiles_large_damage (void)
+{
+  TestBuffers buffers;
+  int i;
+
+  /* Large enough for the tiles to be compared on multiple threads */
+  test_buffers_init (&buffers, 1366, 771, 20);
+
+  for (i = 0; i < N_ROUNDS; i++)
+    {
+      cairo_region_t *damage_region;
+      cairo_rectangle_int_t rect;
+
+      damage_region = create_random_damage (0, 0,
+                                            buffers.width, buffers.height,
+                                            256);
+
+      /* Make sure the damage covers a large part of the framebuffer, not
+       * aligned to the tile grid.
+       */
+      rect.x = g_test_rand_int_range (0, 40);
+      rect.y = g_test_rand_int_range (0, 40);
+      rect.width = buffers.width - rect.x;
+      rect.height = buffers.height - rect.y - g_test_rand_int_range (0, 40);
+      cairo_region_union_rectangle (damage_region, &rect);
+
+      randomize_changes (&buffers);
+      assert_damage_matches_reference (&buffers, damage_region, 32);
+
+      cairo_region_destroy (damage_region);
+    }
+
+  test_buffers_clear (&buffers);
+}
+
+static void
+damage_tiles_unchanged (void)
+{
+  TestBuffers buffers;
+  cairo_rectangle_int_t rect;
+  cairo_region_t *damage_region;
+  cairo_region_t *region;
+
+  test_buffers_init (&buffers, 1366, 771, 20);
+  memcpy (buffers.current_data, buffers.prev_data,
+          (size_t) buffers.stride * buffers.height);
+
+  rect = (cairo_rectangle_int_t) {
+    .width = buffers.width,
+    .height = buffers.height,
+  };
+  damage_region = cairo_region_create_rectangle (&rect);
+
+  region = clutter_damage_tiles_find (damage_region,
+                                      buffers.current_data,
+                                      buffers.prev_data,
+                                      buffers.width,
+                                      buffers.height,
+                                      buffers.stride,
+                                      BPP);
+  g_assert_true (cairo_region_is_empty (region));
+
+  cairo_region_destroy (region);
+  cairo_region_destroy (damage_region);
+  test_buffers_clear (&buffers);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/damage-tiles/small-damage", damage_tiles_small_damage)
+  CLUTTER_TEST_UNIT ("/damage-tiles/large-damage", damage_tiles_large_damage)
+  CLUTTER_TEST_UNIT ("/damage-tiles/unchanged", damage_tiles_unchanged)
+)
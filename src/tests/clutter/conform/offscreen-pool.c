@@ -0,0 +1,157 @@
+#include "clutter/clutter.h"
+#include "clutter/clutter-offscreen-pool.h"
+#include "tests/clutter-test-utils.h"
+
+static void
+offscreen_pool_reuse (void)
+{
+  CoglContext *cogl_context =
+    clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  ClutterOffscreenPool *pool;
+  ClutterOffscreenPoolStats stats;
+  CoglOffscreen *offscreen;
+  CoglOffscreen *other_offscreen;
+  CoglTexture *texture;
+  GError *error = NULL;
+
+  pool = clutter_offscreen_pool_new (cogl_context);
+
+  offscreen = clutter_offscreen_pool_acquire (pool, 64, 32, &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (offscreen);
+
+  texture = cogl_offscreen_get_texture (offscreen);
+  g_assert_cmpint (cogl_texture_get_width (texture), ==, 64);
+  g_assert_cmpint (cogl_texture_get_height (texture), ==, 32);
+
+  clutter_offscreen_pool_release (pool, offscreen);
+  clutter_offscreen_pool_get_stats (pool, &stats);
+  g_assert_cmpuint (stats.n_allocated, ==, 1);
+  g_assert_cmpuint (stats.n_pooled, ==, 1);
+  g_assert_cmpuint (stats.pooled_bytes, ==, 64 * 32 * 4);
+
+  /* A target of the same size is handed out again */
+  other_offscreen = clutter_offscreen_pool_acquire (pool, 64, 32, &error);
+  g_assert_no_error (error);
+  g_assert (other_offscreen == offscreen);
+
+  clutter_offscreen_pool_get_stats (pool, &stats);
+  g_assert_cmpuint (stats.n_allocated, ==, 1);
+  g_assert_cmpuint (stats.n_reused, ==, 1);
+  g_assert_cmpuint (stats.n_pooled, ==, 0);
+  g_assert_cmpuint (stats.pooled_bytes, ==, 0);
+
+  /* ...but not for a different size */
+  other_offscreen = clutter_offscreen_pool_acquire (pool, 16, 16, &error);
+  g_assert_no_error (error);
+  g_assert (other_offscreen != offscreen);
+
+  clutter_offscreen_pool_get_stats (pool, &stats);
+  g_assert_cmpuint (stats.n_allocated, ==, 2);
+
+  clutter_offscreen_pool_release (pool, offscreen);
+  clutter_offscreen_pool_release (pool, other_offscreen);
+
+  clutter_offscreen_pool_free (pool);
+}
+
+static void
+offscreen_pool_trim (void)
+{
+  CoglContext *cogl_context =
+    clutter_backend_get_cogl_context (clutter_get_default_backend ());
+  ClutterOffscreenPool *pool;
+  ClutterOffscreenPoolStats stats;
+  CoglOffscreen *large_offscreen;
+  CoglOffscreen *small_offscreen;
+
+  pool = clutter_offscreen_pool_new (cogl_context);
+
+  large_offscreen = clutter_offscreen_pool_acquire (pool, 64, 64, NULL);
+  small_offscreen = clutter_offscreen_pool_acquire (pool, 16, 16, NULL);
+  g_assert_nonnull (large_offscreen);
+  g_assert_nonnull (small_offscreen);
+
+  clutter_offscreen_pool_release (pool, large_offscreen);
+  clutter_offscreen_pool_release (pool, small_offscreen);
+
+  /* Only the least recently released target should go */
+  clutter_offscreen_pool_trim (pool, G_MAXINT64, 16 * 16 * 4);
+  clutter_offscreen_pool_get_stats (pool, &stats);
+  g_assert_cmpuint (stats.n_trimmed, ==, 1);
+  g_assert_cmpuint (stats.n_pooled, ==, 1);
+  g_assert_cmpuint (stats.pooled_bytes, ==, 16 * 16 * 4);
+
+  small_offscreen = clutter_offscreen_pool_acquire (pool, 16, 16, NULL);
+  clutter_offscreen_pool_get_stats (pool, &stats);
+  g_assert_cmpuint (stats.n_reused, ==, 1);
+
+  clutter_offscreen_pool_release (pool, small_offscreen);
+  clutter_offscreen_pool_purge (pool);
+  clutter_offscreen_pool_get_stats (pool, &stats);
+  g_assert_cmpuint (stats.n_trimmed, ==, 2);
+  g_assert_cmpuint (stats.n_pooled, ==, 0);
+  g_assert_cmpuint (stats.pooled_bytes, ==, 0);
+
+  clutter_offscreen_pool_free (pool);
+}
+
+static void
+on_presented (ClutterStage     *stage,
+              ClutterStageView *view,
+              ClutterFrameInfo *frame_info,
+              gboolean         *was_presented)
+{
+  *was_presented = TRUE;
+}
+
+static void
+offscreen_pool_purge_effects (void)
+{
+  ClutterActor *stage = clutter_test_get_stage ();
+  ClutterOffscreenPool *pool = clutter_offscreen_pool_get_default ();
+  ClutterOffscreenPoolStats stats;
+  ClutterActor *actors[2];
+  gboolean was_presented;
+  unsigned int i;
+
+  for (i = 0; i < G_N_ELEMENTS (actors); i++)
+    {
+      actors[i] = clutter_actor_new ();
+      clutter_actor_set_size (actors[i], 32, 32);
+      clutter_actor_set_position (actors[i], i * 64, 0);
+      clutter_actor_set_background_color (actors[i], CLUTTER_COLOR_Red);
+      clutter_actor_add_effect (actors[i], clutter_desaturate_effect_new (0.5));
+      clutter_actor_add_child (stage, actors[i]);
+    }
+
+  g_signal_connect (stage, "presented", G_CALLBACK (on_presented),
+                    &was_presented);
+
+  clutter_actor_show (stage);
+
+  was_presented = FALSE;
+  while (!was_presented)
+    g_main_context_iteration (NULL, FALSE);
+
+  /* Every effect releases its render target before the pool is purged, so
+   * none of them survive.
+   */
+  g_signal_emit_by_name (stage, "gl-video-memory-purged");
+
+  clutter_offscreen_pool_get_stats (pool, &stats);
+  g_assert_cmpuint (stats.n_pooled, ==, 0);
+  g_assert_cmpuint (stats.pooled_bytes, ==, 0);
+  g_assert_cmpuint (stats.n_trimmed, >=, G_N_ELEMENTS (actors));
+
+  g_signal_handlers_disconnect_by_func (stage, on_presented, &was_presented);
+
+  for (i = 0; i < G_N_ELEMENTS (actors); i++)
+    clutter_actor_destroy (actors[i]);
+}
+
+CLUTTER_TEST_SUITE (
+  CLUTTER_TEST_UNIT ("/offscreen-pool/reuse", offscreen_pool_reuse)
+  CLUTTER_TEST_UNIT ("/offscreen-pool/trim", offscreen_pool_trim)
+  CLUTTER_TEST_UNIT ("/offscreen-pool/purge-effects", offscreen_pool_purge_effects)
+)
@@ -0,0 +1,115 @@
+#include <clutter/clutter.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "clutter/clutter-damage-tiles.h"
+
+#define BPP 4
+#define N_ITERATIONS 200
+
+typedef struct _Resolution
+{
+  const char *name;
+  int width;
+  int height;
+} Resolution;
+
+static const Resolution resolutions[] = {
+  { "1080p", 1920, 1080 },
+  { "4K", 3840, 2160 },
+};
+
+static void
+damage_buffer (uint8_t *data,
+               int      stride,
+               int      x,
+               int      y,
+               int      width,
+               int      height)
+{
+  int i;
+
+  for (i = y; i < y + height; i++)
+    memset (data + i * stride + x * BPP, 0xff, width * BPP);
+}
+
+static void
+run_benchmark (const Resolution *resolution,
+               const char       *label,
+               int               damage_width,
+               int               damage_height,
+               gboolean          changed)
+{
+  int stride = resolution->width * BPP;
+  g_autofree uint8_t *prev_data = NULL;
+  g_autofree uint8_t *current_data = NULL;
+  cairo_rectangle_int_t damage_rect;
+  cairo_region_t *damage_region;
+  GTimer *timer;
+  int i;
+
+  prev_data = g_malloc0 (stride * resolution->height);
+  current_data = g_malloc0 (stride * resolution->height);
+
+  damage_rect = (cairo_rectangle_int_t) {
+    .x = (resolution->width - damage_width) / 2,
+    .y = (resolution->height - damage_height) / 2,
+    .width = damage_width,
+    .height = damage_height,
+  };
+  damage_region = cairo_region_create_rectangle (&damage_rect);
+
+  if (changed)
+    {
+      /* Only a part of the damaged area actually changes. */
+      damage_buffer (current_data, stride,
+                     damage_rect.x + damage_width / 4,
+                     damage_rect.y + damage_height / 4,
+                     damage_width / 8,
+                     damage_height / 8);
+    }
+
+  timer = g_timer_new ();
+  for (i = 0; i < N_ITERATIONS; i++)
+    {
+      cairo_region_t *tile_damage_region;
+
+      tile_damage_region = clutter_damage_tiles_find (damage_region,
+                                                      current_data,
+                                                      prev_data,
+                                                      resolution->width,
+                                                      resolution->height,
+                                                      stride,
+                                                      BPP);
+      cairo_region_destroy (tile_damage_region);
+    }
+  g_timer_stop (timer);
+
+  printf ("%s %s: %.3f ms per diff\n",
+          resolution->name, label,
+          g_timer_elapsed (timer, NULL) * 1000.0 / N_ITERATIONS);
+
+  g_timer_destroy (timer);
+  cairo_region_destroy (damage_region);
+}
+
+int
+main (int argc, char *argv[])
+{
+  unsigned int i;
+
+  for (i = 0; i < G_N_ELEMENTS (resolutions); i++)
+    {
+      const Resolution *resolution = &resolutions[i];
+
+      run_benchmark (resolution, "full damage, unchanged",
+                     resolution->width, resolution->height, FALSE);
+      run_benchmark (resolution, "full damage, partially changed",
+                     resolution->width, resolution->height, TRUE);
+      run_benchmark (resolution, "small damage, partially changed",
+                     256, 256, TRUE);
+    }
+
+  return EXIT_SUCCESS;
+}
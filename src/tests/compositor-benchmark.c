@@ -0,0 +1,460 @@
+/* -*- mode: C; c-file-style: "gnu"; indent-tabs-mode: nil; -*- */
+
+/*
+ * Copyright (C) 2020 Endless Mobile, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Runs a scripted compositor workload against the test backend: a number
+ * of Wayland and X11 test clients are spawned, and their windows are moved,
+ * resized, damaged and switched between workspaces, one frame at a time.
+ *
+ * When run in performance mode (-m perf), more iterations are run and the
+ * wall clock and CPU time per frame are reported as minimized results. If
+ * an output filename is passed, the results, including the frame timing
+ * statistics recorded by the compositor, are written there as JSON.
+ */
+
+#include "config.h"
+
+#include <json-glib/json-glib.h>
+#include <time.h>
+
+#include "backends/meta-backend-private.h"
+#include "compositor/meta-plugin-manager.h"
+#include "core/display-private.h"
+#include "core/main-private.h"
+#include "meta/main.h"
+#include "meta/meta-workspace-manager.h"
+#include "meta/workspace.h"
+#include "tests/meta-backend-test.h"
+#include "tests/test-utils.h"
+#include "x11/meta-x11-display-private.h"
+
+#define N_CLIENTS_PER_TYPE 4
+#define N_ITERATIONS 20
+#define N_PERF_ITERATIONS 200
+
+/* Resize every N iterations, as it involves a client round trip. */
+#define RESIZE_INTERVAL 4
+#define WORKSPACE_SWITCH_INTERVAL 10
+
+typedef struct _BenchmarkWindow
+{
+  TestClient *client;
+  MetaWindow *window;
+} BenchmarkWindow;
+
+typedef struct _Benchmark
+{
+  GList *clients;
+  GArray *windows;
+
+  int64_t n_frames;
+  gulong after_update_handler_id;
+} Benchmark;
+
+static const char *output_path;
+
+static gboolean
+benchmark_alarm_filter (MetaX11Display        *x11_display,
+                        XSyncAlarmNotifyEvent *event,
+                        gpointer               data)
+{
+  Benchmark *benchmark = data;
+  GList *l;
+
+  for (l = benchmark->clients; l; l = l->next)
+    {
+      if (test_client_alarm_filter (x11_display, event, l->data))
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+static void
+on_after_update (ClutterStage     *stage,
+                 ClutterStageView *view,
+                 Benchmark        *benchmark)
+{
+  benchmark->n_frames++;
+}
+
+static void
+wait_for_frame (Benchmark *benchmark)
+{
+  ClutterActor *stage = meta_backend_get_stage (meta_get_backend ());
+  int64_t n_frames = benchmark->n_frames;
+
+  clutter_stage_schedule_update (CLUTTER_STAGE (stage));
+  while (benchmark->n_frames == n_frames)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+wait_for_clients (Benchmark *benchmark)
+{
+  g_autoptr (GError) error = NULL;
+  GList *l;
+
+  for (l = benchmark->clients; l; l = l->next)
+    {
+      if (!test_client_wait (l->data, &error))
+        g_error ("Failed to wait for client: %s", error->message);
+    }
+}
+
+static void
+spawn_clients (Benchmark            *benchmark,
+               MetaWindowClientType  type,
+               int                   n_clients)
+{
+  int i;
+
+  for (i = 0; i < n_clients; i++)
+    {
+      g_autoptr (GError) error = NULL;
+      g_autofree char *client_id = NULL;
+      BenchmarkWindow benchmark_window;
+      TestClient *client;
+
+      client_id = g_strdup_printf ("%s-%d",
+                                   type == META_WINDOW_CLIENT_TYPE_WAYLAND ?
+                                   "wayland" : "x11",
+                                   i);
+      client = test_client_new (client_id, type, &error);
+      if (!client)
+        g_error ("Failed to launch test client: %s", error->message);
+
+      benchmark->clients = g_list_append (benchmark->clients, client);
+
+      if (!test_client_do (client, &error, "create", "window", NULL) ||
+          !test_client_do (client, &error, "show", "window", NULL) ||
+          !test_client_wait (client, &error))
+        g_error ("Failed to show test window: %s", error->message);
+
+      benchmark_window.client = client;
+      benchmark_window.window = test_client_find_window (client, "window",
+                                                         &error);
+      if (!benchmark_window.window)
+        g_error ("Failed to find test window: %s", error->message);
+
+      test_client_wait_for_window_shown (client, benchmark_window.window);
+
+      g_array_append_val (benchmark->windows, benchmark_window);
+    }
+}
+
+static void
+run_iteration (Benchmark *benchmark,
+               int        iteration)
+{
+  MetaDisplay *display = meta_get_display ();
+  MetaWorkspaceManager *workspace_manager =
+    meta_display_get_workspace_manager (display);
+  g_autoptr (GError) error = NULL;
+  unsigned int i;
+
+  for (i = 0; i < benchmark->windows->len; i++)
+    {
+      BenchmarkWindow *benchmark_window =
+        &g_array_index (benchmark->windows, BenchmarkWindow, i);
+      int x, y;
+
+      x = 20 * i + (iteration * 7) % 200;
+      y = 20 * i + (iteration * 5) % 150;
+      meta_window_move_frame (benchmark_window->window, FALSE, x, y);
+
+      if (iteration % RESIZE_INTERVAL == 0)
+        {
+          g_autofree char *width = NULL;
+          g_autofree char *height = NULL;
+
+          width = g_strdup_printf ("%d", 200 + (iteration * 3) % 100);
+          height = g_strdup_printf ("%d", 150 + (iteration * 2) % 100);
+          if (!test_client_do (benchmark_window->client, &error,
+                               "resize", "window", width, height,
+                               NULL))
+            g_error ("Failed to resize test window: %s", error->message);
+        }
+      else
+        {
+          if (!test_client_do (benchmark_window->client, &error,
+                               "damage", "window",
+                               NULL))
+            g_error ("Failed to damage test window: %s", error->message);
+        }
+    }
+
+  if (iteration % WORKSPACE_SWITCH_INTERVAL == WORKSPACE_SWITCH_INTERVAL - 1)
+    {
+      MetaWorkspace *active_workspace;
+      MetaWorkspace *workspace;
+      int index;
+
+      active_workspace =
+        meta_workspace_manager_get_active_workspace (workspace_manager);
+      index = meta_workspace_index (active_workspace) == 0 ? 1 : 0;
+      workspace =
+        meta_workspace_manager_get_workspace_by_index (workspace_manager,
+                                                       index);
+      meta_workspace_activate (workspace,
+                               meta_display_get_current_time_roundtrip (display));
+    }
+
+  wait_for_clients (benchmark);
+  wait_for_frame (benchmark);
+}
+
+static int64_t
+get_cpu_time_us (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_PROCESS_CPUTIME_ID, &ts);
+
+  return ts.tv_sec * G_USEC_PER_SEC + ts.tv_nsec / 1000;
+}
+
+static void
+add_frame_stats (JsonBuilder *builder,
+                 GVariant    *statistics)
+{
+  GVariantIter views_iter;
+  const char *view_name;
+  GVariantIter *metrics_iter;
+
+  json_builder_set_member_name (builder, "views");
+  json_builder_begin_object (builder);
+
+  g_variant_iter_init (&views_iter, statistics);
+  while (g_variant_iter_next (&views_iter, "{&sa{s(tttat)}}",
+                              &view_name, &metrics_iter))
+    {
+      const char *metric_name;
+      uint64_t count;
+      uint64_t sum;
+      uint64_t max;
+      GVariantIter *buckets_iter;
+
+      json_builder_set_member_name (builder, view_name);
+      json_builder_begin_object (builder);
+
+      while (g_variant_iter_next (metrics_iter, "{&s(tttat)}",
+                                  &metric_name, &count, &sum, &max,
+                                  &buckets_iter))
+        {
+          uint64_t bucket;
+
+          json_builder_set_member_name (builder, metric_name);
+          json_builder_begin_object (builder);
+          json_builder_set_member_name (builder, "count");
+          json_builder_add_int_value (builder, count);
+          json_builder_set_member_name (builder, "sum");
+          json_builder_add_int_value (builder, sum);
+          json_builder_set_member_name (builder, "max");
+          json_builder_add_int_value (builder, max);
+          json_builder_set_member_name (builder, "buckets");
+          json_builder_begin_array (builder);
+          while (g_variant_iter_next (buckets_iter, "t", &bucket))
+            json_builder_add_int_value (builder, bucket);
+          json_builder_end_array (builder);
+          json_builder_end_object (builder);
+
+          g_variant_iter_free (buckets_iter);
+        }
+
+      json_builder_end_object (builder);
+
+      g_variant_iter_free (metrics_iter);
+    }
+
+  json_builder_end_object (builder);
+}
+
+static void
+write_results (const char *path,
+               int         n_iterations,
+               int64_t     n_frames,
+               int64_t     wall_time_us,
+               int64_t     cpu_time_us,
+               GVariant   *statistics)
+{
+  JsonBuilder *builder;
+  JsonGenerator *generator;
+  JsonNode *root;
+  g_autoptr (GError) error = NULL;
+
+  builder = json_builder_new ();
+  json_builder_begin_object (builder);
+  json_builder_set_member_name (builder, "wayland-clients");
+  json_builder_add_int_value (builder, N_CLIENTS_PER_TYPE);
+  json_builder_set_member_name (builder, "x11-clients");
+  json_builder_add_int_value (builder, N_CLIENTS_PER_TYPE);
+  json_builder_set_member_name (builder, "iterations");
+  json_builder_add_int_value (builder, n_iterations);
+  json_builder_set_member_name (builder, "frames");
+  json_builder_add_int_value (builder, n_frames);
+  json_builder_set_member_name (builder, "wall-time-us");
+  json_builder_add_int_value (builder, wall_time_us);
+  json_builder_set_member_name (builder, "cpu-time-us");
+  json_builder_add_int_value (builder, cpu_time_us);
+  add_frame_stats (builder, statistics);
+  json_builder_end_object (builder);
+
+  root = json_builder_get_root (builder);
+  generator = json_generator_new ();
+  json_generator_set_root (generator, root);
+  json_generator_set_pretty (generator, TRUE);
+
+  if (!json_generator_to_file (generator, path, &error))
+    g_error ("Failed to write benchmark results: %s", error->message);
+
+  g_object_unref (generator);
+  json_node_free (root);
+  g_object_unref (builder);
+}
+
+static void
+meta_benchmark_compositor_workload (void)
+{
+  MetaDisplay *display = meta_get_display ();
+  MetaWorkspaceManager *workspace_manager =
+    meta_display_get_workspace_manager (display);
+  MetaBackend *backend = meta_get_backend ();
+  MetaFrameStats *frame_stats = meta_backend_get_frame_stats (backend);
+  ClutterActor *stage = meta_backend_get_stage (backend);
+  g_autoptr (GVariant) statistics = NULL;
+  g_autoptr (GError) error = NULL;
+  Benchmark benchmark = { 0 };
+  int64_t start_cpu_time_us;
+  int64_t cpu_time_us;
+  int64_t wall_time_us;
+  int64_t n_frames;
+  int n_iterations;
+  int i;
+  GList *l;
+
+  test_wait_for_x11_display ();
+  meta_x11_display_set_alarm_filter (display->x11_display,
+                                     benchmark_alarm_filter, &benchmark);
+
+  if (meta_workspace_manager_get_n_workspaces (workspace_manager) < 2)
+    {
+      meta_workspace_manager_append_new_workspace (workspace_manager, FALSE,
+                                                   META_CURRENT_TIME);
+    }
+
+  benchmark.windows = g_array_new (FALSE, FALSE, sizeof (BenchmarkWindow));
+  benchmark.after_update_handler_id =
+    g_signal_connect (stage, "after-update",
+                      G_CALLBACK (on_after_update), &benchmark);
+
+  spawn_clients (&benchmark, META_WINDOW_CLIENT_TYPE_WAYLAND,
+                 N_CLIENTS_PER_TYPE);
+  spawn_clients (&benchmark, META_WINDOW_CLIENT_TYPE_X11,
+                 N_CLIENTS_PER_TYPE);
+
+  wait_for_frame (&benchmark);
+
+  n_iterations = g_test_perf () ? N_PERF_ITERATIONS : N_ITERATIONS;
+
+  meta_frame_stats_reset (frame_stats);
+  n_frames = benchmark.n_frames;
+  start_cpu_time_us = get_cpu_time_us ();
+  g_test_timer_start ();
+
+  for (i = 0; i < n_iterations; i++)
+    run_iteration (&benchmark, i);
+
+  wall_time_us = (int64_t) (g_test_timer_elapsed () * G_USEC_PER_SEC);
+  cpu_time_us = get_cpu_time_us () - start_cpu_time_us;
+  n_frames = benchmark.n_frames - n_frames;
+  statistics =
+    g_variant_ref_sink (meta_frame_stats_get_statistics (frame_stats));
+
+  g_assert_cmpint (n_frames, >=, n_iterations);
+
+  g_test_minimized_result ((double) wall_time_us / n_frames / G_USEC_PER_SEC,
+                           "Wall clock time per frame: %g us",
+                           (double) wall_time_us / n_frames);
+  g_test_minimized_result ((double) cpu_time_us / n_frames / G_USEC_PER_SEC,
+                           "CPU time per frame: %g us",
+                           (double) cpu_time_us / n_frames);
+
+  if (output_path)
+    {
+      write_results (output_path, n_iterations, n_frames,
+                     wall_time_us, cpu_time_us, statistics);
+    }
+
+  g_clear_signal_handler (&benchmark.after_update_handler_id, stage);
+
+  for (l = benchmark.clients; l; l = l->next)
+    {
+      TestClient *client = l->data;
+
+      if (!test_client_quit (client, &error))
+        g_error ("Failed to quit test client: %s", error->message);
+      test_client_destroy (client);
+    }
+  g_list_free (benchmark.clients);
+  g_array_free (benchmark.windows, TRUE);
+
+  meta_x11_display_set_alarm_filter (display->x11_display, NULL, NULL);
+}
+
+static gboolean
+run_tests (gpointer data)
+{
+  gboolean ret;
+
+  ret = g_test_run ();
+
+  meta_quit (ret != 0);
+
+  return FALSE;
+}
+
+static void
+init_tests (int argc, char **argv)
+{
+  if (argc > 1)
+    output_path = argv[1];
+
+  g_test_add_func ("/compositor/benchmark/workload",
+                   meta_benchmark_compositor_workload);
+}
+
+int
+main (int argc, char *argv[])
+{
+  test_init (&argc, &argv);
+  init_tests (argc, argv);
+
+  meta_plugin_manager_load (test_get_plugin_name ());
+
+  meta_override_compositor_configuration (META_COMPOSITOR_TYPE_WAYLAND,
+                                          META_TYPE_BACKEND_TEST);
+
+  meta_init ();
+  meta_register_with_session ();
+
+  g_idle_add (run_tests, NULL);
+
+  return meta_run ();
+}
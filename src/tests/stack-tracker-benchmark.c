@@ -0,0 +1,355 @@
+/* -*- mode: C; c-file-style: "gnu"; indent-tabs-mode: nil; -*- */
+
+/*
+ * Copyright (C) 2020 Endless Mobile, Inc.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Replays a stacking trace (see stack-traces/) against a MetaStackTracker.
+ *
+ * When run in performance mode (-m perf), the trace is replayed a number of
+ * times and the time per replay is reported as a minimized result.
+ */
+
+#include "config.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <X11/Xlib.h>
+
+#include "compositor/meta-plugin-manager.h"
+#include "core/display-private.h"
+#include "core/main-private.h"
+#include "core/stack-tracker.h"
+#include "meta/main.h"
+#include "tests/meta-backend-test.h"
+#include "tests/test-utils.h"
+
+#define N_PERF_ITERATIONS 500
+
+#define N_RESYNC_WINDOWS 200
+#define N_RESYNC_ROUNDS 1000
+#define FIRST_RESYNC_WINDOW 0x1a00001
+
+typedef enum _TraceOpType
+{
+  TRACE_OP_ADD,
+  TRACE_OP_REMOVE,
+  TRACE_OP_RAISE,
+  TRACE_OP_LOWER,
+  TRACE_OP_CREATE,
+  TRACE_OP_DESTROY,
+  TRACE_OP_CONFIGURE,
+  TRACE_OP_GET_STACK,
+} TraceOpType;
+
+typedef struct _TraceOp
+{
+  TraceOpType type;
+  guint64 window;
+  guint64 sibling;
+  gulong serial;
+} TraceOp;
+
+static const char *trace_path;
+
+static GArray *
+load_trace (const char *path)
+{
+  g_autoptr (GError) error = NULL;
+  g_autofree char *contents = NULL;
+  g_auto (GStrv) lines = NULL;
+  GArray *trace;
+  int i;
+
+  if (!g_file_get_contents (path, &contents, NULL, &error))
+    g_error ("Failed to read trace: %s", error->message);
+
+  trace = g_array_new (FALSE, FALSE, sizeof (TraceOp));
+
+  lines = g_strsplit (contents, "\n", -1);
+  for (i = 0; lines[i]; i++)
+    {
+      g_auto (GStrv) argv = NULL;
+      int argc;
+      TraceOp op = { 0 };
+
+      g_strstrip (lines[i]);
+      if (lines[i][0] == '\0' || lines[i][0] == '#')
+        continue;
+
+      argv = g_strsplit_set (lines[i], " \t", -1);
+      argc = g_strv_length (argv);
+
+      if (strcmp (argv[0], "get_stack") == 0)
+        {
+          op.type = TRACE_OP_GET_STACK;
+          g_array_append_val (trace, op);
+          continue;
+        }
+
+      if (strcmp (argv[0], "add") == 0)
+        op.type = TRACE_OP_ADD;
+      else if (strcmp (argv[0], "remove") == 0)
+        op.type = TRACE_OP_REMOVE;
+      else if (strcmp (argv[0], "raise") == 0)
+        op.type = TRACE_OP_RAISE;
+      else if (strcmp (argv[0], "lower") == 0)
+        op.type = TRACE_OP_LOWER;
+      else if (strcmp (argv[0], "create") == 0)
+        op.type = TRACE_OP_CREATE;
+      else if (strcmp (argv[0], "destroy") == 0)
+        op.type = TRACE_OP_DESTROY;
+      else if (strcmp (argv[0], "configure") == 0)
+        op.type = TRACE_OP_CONFIGURE;
+      else
+        g_error ("%s:%d: Unknown operation '%s'", path, i + 1, argv[0]);
+
+      switch (op.type)
+        {
+        case TRACE_OP_RAISE:
+        case TRACE_OP_LOWER:
+        case TRACE_OP_CONFIGURE:
+          if (argc != 4)
+            g_error ("%s:%d: Expected <window> <sibling> <serial>", path, i + 1);
+
+          op.window = g_ascii_strtoull (argv[1], NULL, 0);
+          op.sibling = g_ascii_strtoull (argv[2], NULL, 0);
+          op.serial = g_ascii_strtoull (argv[3], NULL, 0);
+          break;
+        default:
+          if (argc != 3)
+            g_error ("%s:%d: Expected <window> <serial>", path, i + 1);
+
+          op.window = g_ascii_strtoull (argv[1], NULL, 0);
+          op.serial = g_ascii_strtoull (argv[2], NULL, 0);
+          break;
+        }
+
+      g_array_append_val (trace, op);
+    }
+
+  return trace;
+}
+
+static void
+replay_trace (MetaDisplay *display,
+              GArray      *trace)
+{
+  MetaStackTracker *tracker;
+  guint i;
+
+  tracker = meta_stack_tracker_new (display);
+
+  for (i = 0; i < trace->len; i++)
+    {
+      TraceOp *op = &g_array_index (trace, TraceOp, i);
+
+      switch (op->type)
+        {
+        case TRACE_OP_ADD:
+          meta_stack_tracker_record_add (tracker, op->window, op->serial);
+          break;
+        case TRACE_OP_REMOVE:
+          meta_stack_tracker_record_remove (tracker, op->window, op->serial);
+          break;
+        case TRACE_OP_RAISE:
+          meta_stack_tracker_record_raise_above (tracker,
+                                                 op->window, op->sibling,
+                                                 op->serial);
+          break;
+        case TRACE_OP_LOWER:
+          meta_stack_tracker_record_lower_below (tracker,
+                                                 op->window, op->sibling,
+                                                 op->serial);
+          break;
+        case TRACE_OP_CREATE:
+          {
+            XCreateWindowEvent event = { 0 };
+
+            event.type = CreateNotify;
+            event.serial = op->serial;
+            event.window = (Window) op->window;
+            meta_stack_tracker_create_event (tracker, &event);
+            break;
+          }
+        case TRACE_OP_DESTROY:
+          {
+            XDestroyWindowEvent event = { 0 };
+
+            event.type = DestroyNotify;
+            event.serial = op->serial;
+            event.window = (Window) op->window;
+            meta_stack_tracker_destroy_event (tracker, &event);
+            break;
+          }
+        case TRACE_OP_CONFIGURE:
+          {
+            XConfigureEvent event = { 0 };
+
+            event.type = ConfigureNotify;
+            event.serial = op->serial;
+            event.window = (Window) op->window;
+            event.above = (Window) op->sibling;
+            meta_stack_tracker_configure_event (tracker, &event);
+            break;
+          }
+        case TRACE_OP_GET_STACK:
+          {
+            guint64 *windows;
+            int n_windows;
+
+            meta_stack_tracker_get_stack (tracker, &windows, &n_windows);
+            g_assert_cmpint (n_windows, >, 0);
+            break;
+          }
+        }
+    }
+
+  meta_stack_tracker_free (tracker);
+}
+
+static void
+meta_test_stack_tracker_replay_trace (void)
+{
+  MetaDisplay *display = meta_get_display ();
+  g_autoptr (GArray) trace = NULL;
+  int n_iterations;
+  int i;
+
+  if (!trace_path)
+    trace_path = g_test_get_filename (G_TEST_DIST,
+                                      "tests", "stack-traces",
+                                      "restack-storm.trace",
+                                      NULL);
+
+  trace = load_trace (trace_path);
+  g_assert_cmpuint (trace->len, >, 0);
+
+  n_iterations = g_test_perf () ? N_PERF_ITERATIONS : 1;
+
+  g_test_timer_start ();
+  for (i = 0; i < n_iterations; i++)
+    replay_trace (display, trace);
+
+  g_test_minimized_result (g_test_timer_elapsed () / n_iterations,
+                           "Replayed %u stack operations in %g us",
+                           trace->len,
+                           g_test_timer_last () * G_USEC_PER_SEC / n_iterations);
+}
+
+/* Every prediction is followed by a query of the stack, which rebuilds
+ * the predicted stack from the verified one, and then by the event that
+ * verifies it, which throws the predicted stack away again.
+ */
+static void
+replay_resyncs (MetaDisplay *display)
+{
+  MetaStackTracker *tracker;
+  gulong serial = 1;
+  int i;
+
+  tracker = meta_stack_tracker_new (display);
+
+  for (i = 0; i < N_RESYNC_WINDOWS; i++)
+    meta_stack_tracker_record_add (tracker, FIRST_RESYNC_WINDOW + i, 0);
+
+  for (i = 0; i < N_RESYNC_ROUNDS; i++)
+    {
+      guint64 window = FIRST_RESYNC_WINDOW + (i * 7) % N_RESYNC_WINDOWS;
+      guint64 sibling = FIRST_RESYNC_WINDOW + (i * 13 + 1) % N_RESYNC_WINDOWS;
+      XConfigureEvent event = { 0 };
+      guint64 *windows;
+      int n_windows;
+
+      meta_stack_tracker_record_raise_above (tracker, window, sibling, serial);
+
+      meta_stack_tracker_get_stack (tracker, &windows, &n_windows);
+      g_assert_cmpint (n_windows, ==, N_RESYNC_WINDOWS);
+
+      event.type = ConfigureNotify;
+      event.serial = serial;
+      event.window = (Window) window;
+      event.above = (Window) sibling;
+      meta_stack_tracker_configure_event (tracker, &event);
+
+      serial++;
+    }
+
+  meta_stack_tracker_free (tracker);
+}
+
+static void
+meta_test_stack_tracker_resync (void)
+{
+  MetaDisplay *display = meta_get_display ();
+  int n_iterations;
+  int i;
+
+  n_iterations = g_test_perf () ? N_PERF_ITERATIONS : 1;
+
+  g_test_timer_start ();
+  for (i = 0; i < n_iterations; i++)
+    replay_resyncs (display);
+
+  g_test_minimized_result (g_test_timer_elapsed () / n_iterations,
+                           "Resynced a stack of %d windows %d times in %g us",
+                           N_RESYNC_WINDOWS, N_RESYNC_ROUNDS,
+                           g_test_timer_last () * G_USEC_PER_SEC / n_iterations);
+}
+
+static gboolean
+run_tests (gpointer data)
+{
+  gboolean ret;
+
+  ret = g_test_run ();
+
+  meta_quit (ret != 0);
+
+  return FALSE;
+}
+
+static void
+init_tests (int argc, char **argv)
+{
+  if (argc > 1)
+    trace_path = argv[1];
+
+  g_test_add_func ("/core/stack-tracker/replay-trace",
+                   meta_test_stack_tracker_replay_trace);
+  g_test_add_func ("/core/stack-tracker/resync",
+                   meta_test_stack_tracker_resync);
+}
+
+int
+main (int argc, char *argv[])
+{
+  test_init (&argc, &argv);
+  init_tests (argc, argv);
+
+  meta_plugin_manager_load (test_get_plugin_name ());
+
+  meta_override_compositor_configuration (META_COMPOSITOR_TYPE_WAYLAND,
+                                          META_TYPE_BACKEND_TEST);
+
+  meta_init ();
+  meta_register_with_session ();
+
+  g_idle_add (run_tests, NULL);
+
+  return meta_run ();
+}
@@ -587,6 +587,20 @@ process_line (const char *line)
                          width,
                          height - titlebar_height);
     }
+  else if (strcmp (argv[0], "damage") == 0)
+    {
+      if (argc != 2)
+        {
+          g_print ("usage: damage <id>\n");
+          goto out;
+        }
+
+      GtkWidget *window = lookup_window (argv[1]);
+      if (!window)
+        goto out;
+
+      gtk_widget_queue_draw (window);
+    }
   else if (strcmp (argv[0], "raise") == 0)
     {
       if (argc != 2)
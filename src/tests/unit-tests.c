@@ -186,6 +186,73 @@ meta_test_util_later_schedule_from_later (void)
   g_assert_cmpint (data.state, ==, META_TEST_LATER_FINISHED);
 }
 
+typedef struct _MetaTestLaterRemoveData
+{
+  GMainLoop *loop;
+  unsigned int other_later_id;
+  gboolean removed_later_invoked;
+} MetaTestLaterRemoveData;
+
+static gboolean
+test_later_remove_removed_callback (gpointer user_data)
+{
+  MetaTestLaterRemoveData *data = user_data;
+
+  data->removed_later_invoked = TRUE;
+
+  return FALSE;
+}
+
+static gboolean
+test_later_remove_removing_callback (gpointer user_data)
+{
+  MetaTestLaterRemoveData *data = user_data;
+
+  meta_later_remove (data->other_later_id);
+
+  return FALSE;
+}
+
+static gboolean
+test_later_remove_last_callback (gpointer user_data)
+{
+  MetaTestLaterRemoveData *data = user_data;
+
+  g_main_loop_quit (data->loop);
+
+  return FALSE;
+}
+
+static void
+meta_test_util_later_remove_from_later (void)
+{
+  MetaTestLaterRemoveData data = { 0 };
+
+  data.loop = g_main_loop_new (NULL, FALSE);
+
+  /* Test that a later removed by another later of the same phase, which is
+   * run before it, isn't invoked. Laters of a phase are invoked in the
+   * opposite order of them being added.
+   */
+  meta_later_add (META_LATER_BEFORE_REDRAW,
+                  test_later_remove_last_callback,
+                  &data,
+                  NULL);
+  data.other_later_id = meta_later_add (META_LATER_BEFORE_REDRAW,
+                                        test_later_remove_removed_callback,
+                                        &data,
+                                        NULL);
+  meta_later_add (META_LATER_BEFORE_REDRAW,
+                  test_later_remove_removing_callback,
+                  &data,
+                  NULL);
+
+  g_main_loop_run (data.loop);
+  g_main_loop_unref (data.loop);
+
+  g_assert_false (data.removed_later_invoked);
+}
+
 static void
 meta_test_adjacent_to (void)
 {
@@ -247,6 +314,8 @@ init_tests (int argc, char **argv)
   g_test_add_func ("/util/meta-later/order", meta_test_util_later_order);
   g_test_add_func ("/util/meta-later/schedule-from-later",
                    meta_test_util_later_schedule_from_later);
+  g_test_add_func ("/util/meta-later/remove-from-later",
+                   meta_test_util_later_remove_from_later);
 
   g_test_add_func ("/core/boxes/adjacent-to", meta_test_adjacent_to);
 
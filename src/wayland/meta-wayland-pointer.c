@@ -282,39 +282,26 @@ meta_wayland_pointer_broadcast_frame (MetaWaylandPointer *pointer)
     }
 }
 
-void
-meta_wayland_pointer_send_relative_motion (MetaWaylandPointer *pointer,
-                                           const ClutterEvent *event)
-{
 #ifdef HAVE_NATIVE_BACKEND
+static void
+send_relative_motion (MetaWaylandPointer          *pointer,
+                      const MetaEventNativeMotion *motion)
+{
   struct wl_resource *resource;
-  double dx, dy;
-  double dx_unaccel, dy_unaccel;
-  uint64_t time_us;
   uint32_t time_us_hi;
   uint32_t time_us_lo;
   wl_fixed_t dxf, dyf;
   wl_fixed_t dx_unaccelf, dy_unaccelf;
-  MetaBackend *backend = meta_get_backend ();
 
-  if (!pointer->focus_client)
+  if (!motion->has_relative_motion)
     return;
 
-  if (!META_IS_BACKEND_NATIVE (backend) ||
-      !meta_event_native_get_relative_motion (event,
-                                              &dx, &dy,
-                                              &dx_unaccel, &dy_unaccel))
-    return;
-
-  time_us = meta_event_native_get_time_usec (event);
-  if (time_us == 0)
-    time_us = clutter_event_get_time (event) * 1000ULL;
-  time_us_hi = (uint32_t) (time_us >> 32);
-  time_us_lo = (uint32_t) time_us;
-  dxf = wl_fixed_from_double (dx);
-  dyf = wl_fixed_from_double (dy);
-  dx_unaccelf = wl_fixed_from_double (dx_unaccel);
-  dy_unaccelf = wl_fixed_from_double (dy_unaccel);
+  time_us_hi = (uint32_t) (motion->time_usec >> 32);
+  time_us_lo = (uint32_t) motion->time_usec;
+  dxf = wl_fixed_from_double (motion->dx);
+  dyf = wl_fixed_from_double (motion->dy);
+  dx_unaccelf = wl_fixed_from_double (motion->dx_unaccel);
+  dy_unaccelf = wl_fixed_from_double (motion->dy_unaccel);
 
   wl_resource_for_each (resource,
                         &pointer->focus_client->relative_pointer_resources)
@@ -327,24 +314,86 @@ meta_wayland_pointer_send_relative_motion (MetaWaylandPointer *pointer,
                                                     dx_unaccelf,
                                                     dy_unaccelf);
     }
-#endif
 }
 
+static const MetaEventNativeMotion *
+get_motion_history (MetaWaylandPointer *pointer,
+                    const ClutterEvent *event,
+                    unsigned int       *n_motions)
+{
+  MetaBackend *backend = meta_get_backend ();
+
+  /* The history of the event that moved the focus may contain positions
+   * on the previous surface; the new one only sees the latest position.
+   */
+  if (!META_IS_BACKEND_NATIVE (backend) ||
+      !pointer->replay_motion_history)
+    {
+      *n_motions = 0;
+      return NULL;
+    }
+
+  return meta_event_native_get_motion_history (event, n_motions);
+}
+#endif
+
 void
-meta_wayland_pointer_send_motion (MetaWaylandPointer *pointer,
-                                  const ClutterEvent *event)
+meta_wayland_pointer_send_relative_motion (MetaWaylandPointer *pointer,
+                                           const ClutterEvent *event)
 {
-  struct wl_resource *resource;
-  uint32_t time;
-  float sx, sy;
+#ifdef HAVE_NATIVE_BACKEND
+  const MetaEventNativeMotion *motions;
+  unsigned int n_motions, i;
+  MetaEventNativeMotion motion = { 0 };
 
   if (!pointer->focus_client)
     return;
 
-  time = clutter_event_get_time (event);
+  /* Motions compressed into this event are sent in frames of their own,
+   * leaving the last one for the caller to terminate.
+   */
+  motions = get_motion_history (pointer, event, &n_motions);
+  if (n_motions > 0)
+    {
+      for (i = 0; i < n_motions - 1; i++)
+        {
+          send_relative_motion (pointer, &motions[i]);
+          meta_wayland_pointer_broadcast_frame (pointer);
+        }
+
+      send_relative_motion (pointer, &motions[n_motions - 1]);
+      return;
+    }
+
+  pointer->replay_motion_history = TRUE;
+
+  if (!META_IS_BACKEND_NATIVE (meta_get_backend ()) ||
+      !meta_event_native_get_relative_motion (event,
+                                              &motion.dx, &motion.dy,
+                                              &motion.dx_unaccel,
+                                              &motion.dy_unaccel))
+    return;
+
+  motion.has_relative_motion = TRUE;
+  motion.time_usec = meta_event_native_get_time_usec (event);
+  if (motion.time_usec == 0)
+    motion.time_usec = clutter_event_get_time (event) * 1000ULL;
+
+  send_relative_motion (pointer, &motion);
+#endif
+}
+
+static void
+send_motion (MetaWaylandPointer *pointer,
+             uint32_t            time,
+             float               x,
+             float               y)
+{
+  struct wl_resource *resource;
+  float sx, sy;
+
   meta_wayland_surface_get_relative_coordinates (pointer->focus_surface,
-                                                 event->motion.x,
-                                                 event->motion.y,
+                                                 x, y,
                                                  &sx, &sy);
 
   wl_resource_for_each (resource, &pointer->focus_client->pointer_resources)
@@ -353,10 +402,50 @@ meta_wayland_pointer_send_motion (MetaWaylandPointer *pointer,
                               wl_fixed_from_double (sx),
                               wl_fixed_from_double (sy));
     }
+}
+
+void
+meta_wayland_pointer_send_motion (MetaWaylandPointer *pointer,
+                                  const ClutterEvent *event)
+{
+#ifdef HAVE_NATIVE_BACKEND
+  const MetaEventNativeMotion *motions;
+  unsigned int n_motions, i;
+#endif
+
+  if (!pointer->focus_client)
+    return;
+
+#ifdef HAVE_NATIVE_BACKEND
+  /* Replay the motions the stage compressed into this event, so clients
+   * still see every position the device reported.
+   */
+  motions = get_motion_history (pointer, event, &n_motions);
+  if (n_motions > 0)
+    {
+      for (i = 0; i < n_motions; i++)
+        {
+          send_motion (pointer,
+                       (uint32_t) (motions[i].time_usec / 1000),
+                       motions[i].x, motions[i].y);
+          send_relative_motion (pointer, &motions[i]);
+          meta_wayland_pointer_broadcast_frame (pointer);
+        }
+
+      return;
+    }
+#endif
+
+  send_motion (pointer,
+               clutter_event_get_time (event),
+               event->motion.x,
+               event->motion.y);
 
   meta_wayland_pointer_send_relative_motion (pointer, event);
 
   meta_wayland_pointer_broadcast_frame (pointer);
+
+  pointer->replay_motion_history = TRUE;
 }
 
 void
@@ -917,6 +1006,8 @@ meta_wayland_pointer_set_focus (MetaWaylandPointer *pointer,
   if (pointer->focus_surface == surface)
     return;
 
+  pointer->replay_motion_history = FALSE;
+
   if (pointer->focus_surface != NULL)
     {
       uint32_t serial;
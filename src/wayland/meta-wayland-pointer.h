@@ -73,6 +73,9 @@ struct _MetaWaylandPointer
   guint32 focus_serial;
   guint32 click_serial;
 
+  /* FALSE until a motion was sent to the current focus surface */
+  gboolean replay_motion_history;
+
   MetaWaylandSurface *cursor_surface;
   gulong cursor_surface_destroy_id;
 
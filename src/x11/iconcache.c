@@ -28,89 +28,170 @@
 #include <cairo-xlib-xrender.h>
 #include <X11/Xatom.h>
 #include <X11/extensions/Xrender.h>
+#include <gio/gio.h>
+#include <string.h>
 
 #include "meta/meta-x11-errors.h"
 #include "x11/meta-x11-display-private.h"
 
+typedef struct
+{
+  int width;
+  int height;
+
+  /* Offset of the pixel data in the property, in 32 bit items */
+  gulong offset;
+} NetWmIconImage;
+
+typedef struct
+{
+  gulong *items;
+  gulong n_items;
+
+  int ideal_width;
+  int ideal_height;
+  int ideal_mini_width;
+  int ideal_mini_height;
+} NetWmIconLoad;
+
+typedef struct
+{
+  cairo_surface_t *icon;
+  guint icon_hash;
+  cairo_surface_t *mini_icon;
+  guint mini_icon_hash;
+} NetWmIconResult;
+
+typedef struct
+{
+  guint hash;
+  int width;
+  int height;
+
+  /* Not owned; the entry is attached to the surface as user data */
+  cairo_surface_t *surface;
+} IconSurfaceEntry;
+
+static const cairo_user_data_key_t icon_surface_entry_key;
+
+/* Decoded _NET_WM_ICON images, shared between all windows that have
+ * the same icon.
+ */
+static GHashTable *icon_surfaces;
+
 static gboolean
-find_largest_sizes (gulong *data,
-                    gulong  nitems,
-                    int    *width,
-                    int    *height)
+get_net_wm_icon (MetaX11Display  *x11_display,
+                 Window           xwindow,
+                 gulong         **items,
+                 gulong          *n_items)
 {
-  *width = 0;
-  *height = 0;
+  Atom type;
+  int format;
+  gulong bytes_after;
+  int result, err;
+  guchar *data;
 
-  while (nitems > 0)
+  meta_x11_error_trap_push (x11_display);
+  type = None;
+  data = NULL;
+  result = XGetWindowProperty (x11_display->xdisplay,
+                               xwindow,
+                               x11_display->atom__NET_WM_ICON,
+                               0, G_MAXLONG,
+                               False, XA_CARDINAL, &type, &format, n_items,
+                               &bytes_after, &data);
+  err = meta_x11_error_trap_pop_with_return (x11_display);
+
+  if (err != Success ||
+      result != Success)
+    return FALSE;
+
+  if (type != XA_CARDINAL || format != 32 || *n_items == 0)
     {
-      int w, h;
+      XFree (data);
+      return FALSE;
+    }
 
-      if (nitems < 3)
-        return FALSE; /* no space for w, h */
+  *items = (gulong *) data;
 
-      w = data[0];
-      h = data[1];
+  return TRUE;
+}
 
-      if (nitems < ((gulong)(w * h) + 2))
-        return FALSE; /* not enough data */
+static GArray *
+list_net_wm_icon_images (gulong *items,
+                         gulong  n_items)
+{
+  GArray *images;
+  gulong offset = 0;
+
+  images = g_array_new (FALSE, FALSE, sizeof (NetWmIconImage));
+
+  while (offset < n_items)
+    {
+      NetWmIconImage image;
+      gulong width, height;
+      gulong n_pixels;
+
+      if (n_items - offset < 2)
+        goto invalid; /* no space for w, h */
+
+      /* Check the size before it is narrowed to int */
+      width = items[offset];
+      height = items[offset + 1];
+      if (width == 0 || height == 0 ||
+          width > G_MAXUINT16 || height > G_MAXUINT16)
+        goto invalid;
 
-      *width = MAX (w, *width);
-      *height = MAX (h, *height);
+      image.width = width;
+      image.height = height;
+      image.offset = offset + 2;
 
-      data += (w * h) + 2;
-      nitems -= (w * h) + 2;
+      n_pixels = width * height;
+      if (n_items - image.offset < n_pixels)
+        goto invalid; /* not enough data */
+
+      g_array_append_val (images, image);
+
+      offset = image.offset + n_pixels;
     }
 
-  return TRUE;
+  return images;
+
+invalid:
+  g_array_free (images, TRUE);
+  return NULL;
 }
 
-static gboolean
-find_best_size (gulong  *data,
-                gulong   nitems,
-                int      ideal_width,
-                int      ideal_height,
-                int     *width,
-                int     *height,
-                gulong **start)
+static const NetWmIconImage *
+find_best_size (GArray *images,
+                int     ideal_width,
+                int     ideal_height)
 {
-  int best_w;
-  int best_h;
-  gulong *best_start;
-  int max_width, max_height;
+  const NetWmIconImage *best = NULL;
+  int max_width = 0, max_height = 0;
+  guint i;
 
-  *width = 0;
-  *height = 0;
-  *start = NULL;
+  for (i = 0; i < images->len; i++)
+    {
+      const NetWmIconImage *image = &g_array_index (images, NetWmIconImage, i);
 
-  if (!find_largest_sizes (data, nitems, &max_width, &max_height))
-    return FALSE;
+      max_width = MAX (image->width, max_width);
+      max_height = MAX (image->height, max_height);
+    }
 
   if (ideal_width < 0)
     ideal_width = max_width;
   if (ideal_height < 0)
     ideal_height = max_height;
 
-  best_w = 0;
-  best_h = 0;
-  best_start = NULL;
-
-  while (nitems > 0)
+  for (i = 0; i < images->len; i++)
     {
-      int w, h;
+      const NetWmIconImage *image = &g_array_index (images, NetWmIconImage, i);
       gboolean replace;
 
       replace = FALSE;
 
-      if (nitems < 3)
-        return FALSE; /* no space for w, h */
-
-      w = data[0];
-      h = data[1];
-
-      if (nitems < ((gulong)(w * h) + 2))
-        break; /* not enough data */
-
-      if (best_start == NULL)
+      if (best == NULL)
         {
           replace = TRUE;
         }
@@ -118,8 +199,8 @@ find_best_size (gulong  *data,
         {
           /* work with averages */
           const int ideal_size = (ideal_width + ideal_height) / 2;
-          int best_size = (best_w + best_h) / 2;
-          int this_size = (w + h) / 2;
+          int best_size = (best->width + best->height) / 2;
+          int this_size = (image->width + image->height) / 2;
 
           /* larger than desired is always better than smaller */
           if (best_size < ideal_size &&
@@ -139,29 +220,35 @@ find_best_size (gulong  *data,
         }
 
       if (replace)
-        {
-          best_start = data + 2;
-          best_w = w;
-          best_h = h;
-        }
-
-      data += (w * h) + 2;
-      nitems -= (w * h) + 2;
+        best = image;
     }
 
-  if (best_start)
-    {
-      *start = best_start;
-      *width = best_w;
-      *height = best_h;
-      return TRUE;
-    }
-  else
-    return FALSE;
+  return best;
+}
+
+static inline uint32_t
+premultiply_argb (gulong argb)
+{
+  uint32_t a = (argb >> 24) & 0xff;
+  uint32_t r, g, b;
+
+  if (a == 0xff)
+    return (uint32_t) argb;
+  else if (a == 0)
+    return 0;
+
+  r = (((argb >> 16) & 0xff) * a + 127) / 255;
+  g = (((argb >> 8) & 0xff) * a + 127) / 255;
+  b = ((argb & 0xff) * a + 127) / 255;
+
+  return (a << 24) | (r << 16) | (g << 8) | b;
 }
 
 static cairo_surface_t *
-argbdata_to_surface (gulong *argb_data, int w, int h)
+argbdata_to_surface (gulong *argb_data,
+                     int     w,
+                     int     h,
+                     guint  *hash)
 {
   cairo_surface_t *surface;
   int y, x, stride;
@@ -171,14 +258,16 @@ argbdata_to_surface (gulong *argb_data, int w, int h)
   stride = cairo_image_surface_get_stride (surface) / sizeof (uint32_t);
   data = (uint32_t *) cairo_image_surface_get_data (surface);
 
-  /* One could speed this up a lot. */
+  *hash = 5381;
+
   for (y = 0; y < h; y++)
     {
       for (x = 0; x < w; x++)
         {
           uint32_t *p = &data[y * stride + x];
           gulong *d = &argb_data[y * w + x];
-          *p = *d;
+          *p = premultiply_argb (*d);
+          *hash = (*hash << 5) + *hash + *p;
         }
     }
 
@@ -188,70 +277,251 @@ argbdata_to_surface (gulong *argb_data, int w, int h)
 }
 
 static gboolean
-read_rgb_icon (MetaX11Display   *x11_display,
-               Window            xwindow,
-               int               ideal_width,
-               int               ideal_height,
-               int               ideal_mini_width,
-               int               ideal_mini_height,
-               cairo_surface_t **icon,
-               cairo_surface_t **mini_icon)
+icon_surface_data_equal (cairo_surface_t *a,
+                         cairo_surface_t *b)
 {
-  Atom type;
-  int format;
-  gulong nitems;
-  gulong bytes_after;
-  int result, err;
-  guchar *data;
-  gulong *best;
-  int w, h;
-  gulong *best_mini;
-  int mini_w, mini_h;
-  gulong *data_as_long;
+  int stride = cairo_image_surface_get_stride (a);
+  int height = cairo_image_surface_get_height (a);
 
-  meta_x11_error_trap_push (x11_display);
-  type = None;
-  data = NULL;
-  result = XGetWindowProperty (x11_display->xdisplay,
-			       xwindow,
-                               x11_display->atom__NET_WM_ICON,
-			       0, G_MAXLONG,
-			       False, XA_CARDINAL, &type, &format, &nitems,
-			       &bytes_after, &data);
-  err = meta_x11_error_trap_pop_with_return (x11_display);
-
-  if (err != Success ||
-      result != Success)
+  if (stride != cairo_image_surface_get_stride (b))
     return FALSE;
 
-  if (type != XA_CARDINAL)
+  return memcmp (cairo_image_surface_get_data (a),
+                 cairo_image_surface_get_data (b),
+                 (size_t) stride * height) == 0;
+}
+
+static guint
+icon_surface_entry_hash (gconstpointer key)
+{
+  const IconSurfaceEntry *entry = key;
+
+  return entry->hash;
+}
+
+static gboolean
+icon_surface_entry_equal (gconstpointer a,
+                          gconstpointer b)
+{
+  const IconSurfaceEntry *entry_a = a;
+  const IconSurfaceEntry *entry_b = b;
+
+  return (entry_a->hash == entry_b->hash &&
+          entry_a->width == entry_b->width &&
+          entry_a->height == entry_b->height);
+}
+
+static void
+icon_surface_entry_free (gpointer data)
+{
+  IconSurfaceEntry *entry = data;
+
+  if (g_hash_table_lookup (icon_surfaces, entry) == entry)
+    g_hash_table_remove (icon_surfaces, entry);
+
+  g_free (entry);
+}
+
+/* Takes ownership of @surface, and returns either it or an identical
+ * surface that is already in use.
+ */
+static cairo_surface_t *
+share_icon_surface (cairo_surface_t *surface,
+                    guint            hash)
+{
+  IconSurfaceEntry key;
+  IconSurfaceEntry *entry;
+
+  if (!icon_surfaces)
+    icon_surfaces = g_hash_table_new (icon_surface_entry_hash,
+                                      icon_surface_entry_equal);
+
+  key.hash = hash;
+  key.width = cairo_image_surface_get_width (surface);
+  key.height = cairo_image_surface_get_height (surface);
+
+  entry = g_hash_table_lookup (icon_surfaces, &key);
+  if (entry &&
+      (entry->surface == surface ||
+       icon_surface_data_equal (entry->surface, surface)))
     {
-      XFree (data);
-      return FALSE;
+      cairo_surface_t *shared;
+
+      shared = cairo_surface_reference (entry->surface);
+      cairo_surface_destroy (surface);
+
+      return shared;
+    }
+
+  /* On a hash collision, the new surface is just not shared */
+  if (!entry)
+    {
+      entry = g_memdup (&key, sizeof (key));
+      entry->surface = surface;
+      cairo_surface_set_user_data (surface, &icon_surface_entry_key,
+                                   entry, icon_surface_entry_free);
+      g_hash_table_add (icon_surfaces, entry);
     }
 
-  data_as_long = (gulong *)data;
+  return surface;
+}
 
-  if (!find_best_size (data_as_long, nitems,
-                       ideal_width, ideal_height,
-                       &w, &h, &best))
+static void
+net_wm_icon_load_free (gpointer data)
+{
+  NetWmIconLoad *load = data;
+
+  XFree (load->items);
+  g_free (load);
+}
+
+static void
+net_wm_icon_result_free (gpointer data)
+{
+  NetWmIconResult *result = data;
+
+  g_clear_pointer (&result->icon, cairo_surface_destroy);
+  g_clear_pointer (&result->mini_icon, cairo_surface_destroy);
+  g_free (result);
+}
+
+static void
+decode_net_wm_icon_in_thread (GTask        *task,
+                              gpointer      source_object,
+                              gpointer      task_data,
+                              GCancellable *cancellable)
+{
+  NetWmIconLoad *load = task_data;
+  NetWmIconResult *result;
+  GArray *images;
+  const NetWmIconImage *best;
+  const NetWmIconImage *best_mini;
+
+  images = list_net_wm_icon_images (load->items, load->n_items);
+  if (!images)
     {
-      XFree (data);
-      return FALSE;
+      g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                               "Invalid _NET_WM_ICON property");
+      return;
     }
 
-  if (!find_best_size (data_as_long, nitems,
-                       ideal_mini_width, ideal_mini_height,
-                       &mini_w, &mini_h, &best_mini))
+  /* The property often contains many sizes of the same icon; only the
+   * ones that fit best are converted.
+   */
+  best = find_best_size (images, load->ideal_width, load->ideal_height);
+  best_mini = find_best_size (images,
+                              load->ideal_mini_width,
+                              load->ideal_mini_height);
+
+  result = g_new0 (NetWmIconResult, 1);
+  result->icon = argbdata_to_surface (&load->items[best->offset],
+                                      best->width, best->height,
+                                      &result->icon_hash);
+
+  if (best_mini == best)
     {
-      XFree (data);
-      return FALSE;
+      result->mini_icon = cairo_surface_reference (result->icon);
+      result->mini_icon_hash = result->icon_hash;
+    }
+  else
+    {
+      result->mini_icon = argbdata_to_surface (&load->items[best_mini->offset],
+                                               best_mini->width,
+                                               best_mini->height,
+                                               &result->mini_icon_hash);
     }
 
-  *icon = argbdata_to_surface (best, w, h);
-  *mini_icon = argbdata_to_surface (best_mini, mini_w, mini_h);
+  g_array_free (images, TRUE);
 
-  XFree (data);
+  g_task_return_pointer (task, result, net_wm_icon_result_free);
+}
+
+static void
+on_net_wm_icon_decoded (GObject      *source_object,
+                        GAsyncResult *res,
+                        gpointer      user_data)
+{
+  MetaIconCache *icon_cache = user_data;
+  NetWmIconResult *result;
+  g_autoptr (GError) error = NULL;
+
+  result = g_task_propagate_pointer (G_TASK (res), &error);
+  if (!result)
+    {
+      /* The icon cache may be gone already */
+      if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        return;
+    }
+  else
+    {
+      icon_cache->net_wm_icon =
+        share_icon_surface (g_steal_pointer (&result->icon),
+                            result->icon_hash);
+      icon_cache->net_wm_mini_icon =
+        share_icon_surface (g_steal_pointer (&result->mini_icon),
+                            result->mini_icon_hash);
+      net_wm_icon_result_free (result);
+    }
+
+  g_clear_object (&icon_cache->net_wm_icon_cancellable);
+  icon_cache->net_wm_icon_loaded = TRUE;
+
+  if (icon_cache->loaded_func)
+    icon_cache->loaded_func (icon_cache->loaded_data);
+}
+
+static void
+cancel_net_wm_icon_load (MetaIconCache *icon_cache)
+{
+  if (icon_cache->net_wm_icon_cancellable)
+    {
+      g_cancellable_cancel (icon_cache->net_wm_icon_cancellable);
+      g_clear_object (&icon_cache->net_wm_icon_cancellable);
+    }
+
+  g_clear_pointer (&icon_cache->net_wm_icon, cairo_surface_destroy);
+  g_clear_pointer (&icon_cache->net_wm_mini_icon, cairo_surface_destroy);
+  icon_cache->net_wm_icon_loaded = FALSE;
+}
+
+/* Fetches _NET_WM_ICON in one request, and leaves picking the sizes
+ * and converting the pixel data, which can be megabytes, to a thread.
+ */
+static gboolean
+load_net_wm_icon (MetaX11Display *x11_display,
+                  Window          xwindow,
+                  MetaIconCache  *icon_cache,
+                  int             ideal_width,
+                  int             ideal_height,
+                  int             ideal_mini_width,
+                  int             ideal_mini_height)
+{
+  NetWmIconLoad *load;
+  GTask *task;
+  gulong *items;
+  gulong n_items;
+
+  cancel_net_wm_icon_load (icon_cache);
+
+  if (!get_net_wm_icon (x11_display, xwindow, &items, &n_items))
+    return FALSE;
+
+  load = g_new0 (NetWmIconLoad, 1);
+  load->items = items;
+  load->n_items = n_items;
+  load->ideal_width = ideal_width;
+  load->ideal_height = ideal_height;
+  load->ideal_mini_width = ideal_mini_width;
+  load->ideal_mini_height = ideal_mini_height;
+
+  icon_cache->net_wm_icon_cancellable = g_cancellable_new ();
+
+  task = g_task_new (NULL, icon_cache->net_wm_icon_cancellable,
+                     on_net_wm_icon_decoded, icon_cache);
+  g_task_set_source_tag (task, load_net_wm_icon);
+  g_task_set_task_data (task, load, net_wm_icon_load_free);
+  g_task_run_in_thread (task, decode_net_wm_icon_in_thread);
+  g_object_unref (task);
 
   return TRUE;
 }
@@ -417,16 +687,32 @@ get_kwm_win_icon (MetaX11Display *x11_display,
 }
 
 void
-meta_icon_cache_init (MetaIconCache *icon_cache)
+meta_icon_cache_init (MetaIconCache           *icon_cache,
+                      MetaIconCacheLoadedFunc  loaded_func,
+                      gpointer                 loaded_data)
 {
   g_return_if_fail (icon_cache != NULL);
 
   icon_cache->origin = USING_NO_ICON;
   icon_cache->prev_pixmap = None;
   icon_cache->prev_mask = None;
+  icon_cache->net_wm_icon_cancellable = NULL;
+  icon_cache->net_wm_icon = NULL;
+  icon_cache->net_wm_mini_icon = NULL;
+  icon_cache->loaded_func = loaded_func;
+  icon_cache->loaded_data = loaded_data;
   icon_cache->wm_hints_dirty = TRUE;
   icon_cache->kwm_win_icon_dirty = TRUE;
   icon_cache->net_wm_icon_dirty = TRUE;
+  icon_cache->net_wm_icon_loaded = FALSE;
+}
+
+void
+meta_icon_cache_clear (MetaIconCache *icon_cache)
+{
+  g_return_if_fail (icon_cache != NULL);
+
+  cancel_net_wm_icon_load (icon_cache);
 }
 
 void
@@ -445,7 +731,9 @@ meta_icon_cache_property_changed (MetaIconCache  *icon_cache,
 gboolean
 meta_icon_cache_get_icon_invalidated (MetaIconCache *icon_cache)
 {
-  if (icon_cache->origin <= USING_KWM_WIN_ICON &&
+  if (icon_cache->net_wm_icon_loaded)
+    return TRUE;
+  else if (icon_cache->origin <= USING_KWM_WIN_ICON &&
       icon_cache->kwm_win_icon_dirty)
     return TRUE;
   else if (icon_cache->origin <= USING_WM_HINTS &&
@@ -497,11 +785,26 @@ meta_read_icons (MetaX11Display   *x11_display,
     {
       icon_cache->net_wm_icon_dirty = FALSE;
 
-      if (read_rgb_icon (x11_display, xwindow,
-                         ideal_width, ideal_height,
-                         ideal_mini_width, ideal_mini_height,
-                         iconp, mini_iconp))
+      if (load_net_wm_icon (x11_display, xwindow, icon_cache,
+                            ideal_width, ideal_height,
+                            ideal_mini_width, ideal_mini_height))
+        return FALSE; /* the loaded_func will ask us again */
+    }
+
+  /* Don't fall back to the other icons while _NET_WM_ICON is still
+   * being decoded
+   */
+  if (icon_cache->net_wm_icon_cancellable)
+    return FALSE;
+
+  if (icon_cache->net_wm_icon_loaded)
+    {
+      icon_cache->net_wm_icon_loaded = FALSE;
+
+      if (icon_cache->net_wm_icon)
         {
+          *iconp = g_steal_pointer (&icon_cache->net_wm_icon);
+          *mini_iconp = g_steal_pointer (&icon_cache->net_wm_mini_icon);
           icon_cache->origin = USING_NET_WM_ICON;
           return TRUE;
         }
@@ -26,6 +26,8 @@
 
 typedef struct _MetaIconCache MetaIconCache;
 
+typedef void (* MetaIconCacheLoadedFunc) (gpointer user_data);
+
 typedef enum
 {
   /* These MUST be in ascending order of preference;
@@ -44,13 +46,25 @@ struct _MetaIconCache
   int origin;
   Pixmap prev_pixmap;
   Pixmap prev_mask;
+  /* _NET_WM_ICON is decoded in a thread; loaded_func is called once
+   * the result can be picked up with meta_read_icons()
+   */
+  GCancellable *net_wm_icon_cancellable;
+  cairo_surface_t *net_wm_icon;
+  cairo_surface_t *net_wm_mini_icon;
+  MetaIconCacheLoadedFunc loaded_func;
+  gpointer loaded_data;
   /* TRUE if these props have changed */
   guint wm_hints_dirty : 1;
   guint kwm_win_icon_dirty : 1;
   guint net_wm_icon_dirty : 1;
+  guint net_wm_icon_loaded : 1;
 };
 
-void           meta_icon_cache_init                 (MetaIconCache  *icon_cache);
+void           meta_icon_cache_init                 (MetaIconCache           *icon_cache,
+                                                     MetaIconCacheLoadedFunc  loaded_func,
+                                                     gpointer                 loaded_data);
+void           meta_icon_cache_clear                (MetaIconCache  *icon_cache);
 void           meta_icon_cache_property_changed     (MetaIconCache  *icon_cache,
                                                      MetaX11Display *x11_display,
                                                      Atom            atom);
@@ -40,6 +40,7 @@
 
 typedef struct _MetaGroupPropHooks  MetaGroupPropHooks;
 typedef struct _MetaWindowPropHooks MetaWindowPropHooks;
+typedef struct _MetaWindowPropsRequest MetaWindowPropsRequest;
 
 typedef gboolean (*MetaAlarmFilter) (MetaX11Display        *x11_display,
                                      XSyncAlarmNotifyEvent *event,
@@ -113,6 +114,7 @@ struct _MetaX11Display
   MetaWindowPropHooks *prop_hooks_table;
   GHashTable *prop_hooks;
   int n_prop_hooks;
+  MetaWindowPropsRequest *pending_initial_props;
 
   /* Managed by group-props.c */
   MetaGroupPropHooks *group_prop_hooks;
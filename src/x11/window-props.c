@@ -59,6 +59,17 @@
 #define HOST_NAME_MAX 255
 #endif
 
+struct _MetaWindowPropsRequest
+{
+  Window xwindow;
+  gboolean override_redirect;
+
+  MetaPropValue *values;
+  int n_values;
+
+  MetaPropRequest *request;
+};
+
 typedef void (* ReloadValueFunc) (MetaWindow    *window,
                                   MetaPropValue *value,
                                   gboolean       initial);
@@ -80,6 +91,9 @@ struct _MetaWindowPropHooks
   MetaPropHookFlags flags;
 };
 
+static void init_prop_value_for_type   (gboolean             override_redirect,
+                                        MetaWindowPropHooks *hooks,
+                                        MetaPropValue       *value);
 static void init_prop_value            (MetaWindow          *window,
                                         MetaWindowPropHooks *hooks,
                                         MetaPropValue       *value);
@@ -129,15 +143,27 @@ meta_window_reload_property (MetaWindow      *window,
                                             initial);
 }
 
+static void
+meta_window_props_request_free (MetaWindowPropsRequest *props_request)
+{
+  g_free (props_request->values);
+  g_free (props_request);
+}
+
 void
-meta_window_load_initial_properties (MetaWindow *window)
+meta_x11_display_request_initial_window_properties (MetaX11Display *x11_display,
+                                                    Window          xwindow,
+                                                    gboolean        override_redirect)
 {
+  MetaWindowPropsRequest *props_request;
   int i, j;
-  MetaPropValue *values;
-  int n_properties = 0;
-  MetaX11Display *x11_display = window->display->x11_display;
 
-  values = g_new0 (MetaPropValue, x11_display->n_prop_hooks);
+  meta_x11_display_cancel_initial_window_properties (x11_display);
+
+  props_request = g_new0 (MetaWindowPropsRequest, 1);
+  props_request->xwindow = xwindow;
+  props_request->override_redirect = override_redirect;
+  props_request->values = g_new0 (MetaPropValue, x11_display->n_prop_hooks);
 
   j = 0;
   for (i = 0; i < x11_display->n_prop_hooks; i++)
@@ -145,14 +171,64 @@ meta_window_load_initial_properties (MetaWindow *window)
       MetaWindowPropHooks *hooks = &x11_display->prop_hooks_table[i];
       if (hooks->flags & LOAD_INIT)
         {
-          init_prop_value (window, hooks, &values[j]);
+          init_prop_value_for_type (override_redirect, hooks,
+                                    &props_request->values[j]);
           ++j;
         }
     }
-  n_properties = j;
+  props_request->n_values = j;
+
+  props_request->request = meta_prop_request_values (x11_display, xwindow,
+                                                     props_request->values,
+                                                     props_request->n_values);
+
+  x11_display->pending_initial_props = props_request;
+}
+
+void
+meta_x11_display_cancel_initial_window_properties (MetaX11Display *x11_display)
+{
+  MetaWindowPropsRequest *props_request = x11_display->pending_initial_props;
+
+  if (!props_request)
+    return;
+
+  meta_prop_request_cancel (props_request->request);
+  meta_window_props_request_free (props_request);
+  x11_display->pending_initial_props = NULL;
+}
+
+void
+meta_window_load_initial_properties (MetaWindow *window)
+{
+  int i, j;
+  MetaPropValue *values;
+  int n_properties = 0;
+  MetaX11Display *x11_display = window->display->x11_display;
+  MetaWindowPropsRequest *props_request = x11_display->pending_initial_props;
+
+  if (props_request &&
+      (props_request->xwindow != window->xwindow ||
+       props_request->override_redirect != window->override_redirect))
+    {
+      meta_x11_display_cancel_initial_window_properties (x11_display);
+      props_request = NULL;
+    }
+
+  if (!props_request)
+    {
+      meta_x11_display_request_initial_window_properties (x11_display,
+                                                          window->xwindow,
+                                                          window->override_redirect);
+      props_request = x11_display->pending_initial_props;
+    }
 
-  meta_prop_get_values (window->display->x11_display, window->xwindow,
-                        values, n_properties);
+  x11_display->pending_initial_props = NULL;
+
+  values = props_request->values;
+  n_properties = props_request->n_values;
+
+  meta_prop_request_finish (props_request->request);
 
   j = 0;
   for (i = 0; i < x11_display->n_prop_hooks; i++)
@@ -173,17 +249,17 @@ meta_window_load_initial_properties (MetaWindow *window)
 
   meta_prop_free_values (values, n_properties);
 
-  g_free (values);
+  meta_window_props_request_free (props_request);
 }
 
 /* Fill in the MetaPropValue used to get the value of "property" */
 static void
-init_prop_value (MetaWindow          *window,
-                 MetaWindowPropHooks *hooks,
-                 MetaPropValue       *value)
+init_prop_value_for_type (gboolean             override_redirect,
+                          MetaWindowPropHooks *hooks,
+                          MetaPropValue       *value)
 {
   if (!hooks || hooks->type == META_PROP_VALUE_INVALID ||
-      (window->override_redirect && !(hooks->flags & INCLUDE_OR)))
+      (override_redirect && !(hooks->flags & INCLUDE_OR)))
     {
       value->type = META_PROP_VALUE_INVALID;
       value->atom = None;
@@ -195,6 +271,14 @@ init_prop_value (MetaWindow          *window,
     }
 }
 
+static void
+init_prop_value (MetaWindow          *window,
+                 MetaWindowPropHooks *hooks,
+                 MetaPropValue       *value)
+{
+  init_prop_value_for_type (window->override_redirect, hooks, value);
+}
+
 static void
 reload_prop_value (MetaWindow          *window,
                    MetaWindowPropHooks *hooks,
@@ -1901,6 +1985,8 @@ meta_x11_display_init_window_prop_hooks (MetaX11Display *x11_display)
 void
 meta_x11_display_free_window_prop_hooks (MetaX11Display *x11_display)
 {
+  meta_x11_display_cancel_initial_window_properties (x11_display);
+
   g_hash_table_unref (x11_display->prop_hooks);
   x11_display->prop_hooks = NULL;
 
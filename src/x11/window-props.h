@@ -49,6 +49,30 @@ void meta_window_reload_property_from_xwindow (MetaWindow      *window,
                                                Atom             property,
                                                gboolean         initial);
 
+/**
+ * meta_x11_display_request_initial_window_properties:
+ * @x11_display:       The X11 display.
+ * @xwindow:           The X handle for the window about to be managed.
+ * @override_redirect: Whether the window is override-redirect.
+ *
+ * Sends the requests for the standard properties of a window that is
+ * about to be managed, without waiting for the replies. They are picked
+ * up by meta_window_load_initial_properties(), so that the round trip
+ * overlaps with the rest of the window setup.
+ */
+void meta_x11_display_request_initial_window_properties (MetaX11Display *x11_display,
+                                                         Window          xwindow,
+                                                         gboolean        override_redirect);
+
+/**
+ * meta_x11_display_cancel_initial_window_properties:
+ * @x11_display:  The X11 display.
+ *
+ * Discards the replies of the requests sent by
+ * meta_x11_display_request_initial_window_properties(), if any.
+ */
+void meta_x11_display_cancel_initial_window_properties (MetaX11Display *x11_display);
+
 /**
  * meta_window_load_initial_properties:
  * @window:      The window.
@@ -56,6 +80,10 @@ void meta_window_reload_property_from_xwindow (MetaWindow      *window,
  * Requests the current values for standard properties for a given
  * window from the server, and deals with them appropriately.
  * Does not return them to the caller (they've been dealt with!)
+ *
+ * If the requests were already sent with
+ * meta_x11_display_request_initial_window_properties(), only the
+ * replies are waited for.
  */
 void meta_window_load_initial_properties (MetaWindow *window);
 
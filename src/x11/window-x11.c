@@ -512,6 +512,14 @@ meta_window_apply_session_info (MetaWindow *window,
     }
 }
 
+static void
+on_icon_loaded (gpointer user_data)
+{
+  MetaWindow *window = user_data;
+
+  meta_window_queue (window, META_QUEUE_UPDATE_ICON);
+}
+
 static void
 meta_window_x11_manage (MetaWindow *window)
 {
@@ -519,7 +527,7 @@ meta_window_x11_manage (MetaWindow *window)
   MetaWindowX11 *window_x11 = META_WINDOW_X11 (window);
   MetaWindowX11Private *priv = meta_window_x11_get_instance_private (window_x11);
 
-  meta_icon_cache_init (&priv->icon_cache);
+  meta_icon_cache_init (&priv->icon_cache, on_icon_loaded, window);
 
   meta_x11_display_register_x_window (display->x11_display,
                                       &window->xwindow,
@@ -632,6 +640,8 @@ meta_window_x11_unmanage (MetaWindow *window)
 
   meta_x11_display_unregister_x_window (x11_display, window->xwindow);
 
+  meta_icon_cache_clear (&priv->icon_cache);
+
   /* Put back anything we messed up */
   if (priv->border_width != 0)
     XSetWindowBorderWidth (x11_display->xdisplay,
@@ -3643,6 +3653,15 @@ meta_window_x11_new (MetaDisplay       *display,
                                &set_attrs);
     }
 
+  /* Now that we are selecting for PropertyNotify, send out the requests
+   * for the initial properties, so that their round trip overlaps with the
+   * XSync() below and the rest of the window setup. They are collected in
+   * meta_window_load_initial_properties().
+   */
+  meta_x11_display_request_initial_window_properties (x11_display,
+                                                      xwindow,
+                                                      attrs.override_redirect);
+
   if (meta_x11_error_trap_pop_with_return (x11_display) != Success)
     {
       meta_verbose ("Window 0x%lx disappeared just as we tried to manage it\n",
@@ -3674,6 +3693,7 @@ meta_window_x11_new (MetaDisplay       *display,
   return window;
 
 error:
+  meta_x11_display_cancel_initial_window_properties (x11_display);
   meta_x11_error_trap_pop (x11_display);
   return NULL;
 }
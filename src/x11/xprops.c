@@ -827,12 +827,38 @@ latin1_to_utf8 (const char *text)
   return g_string_free (str, FALSE);
 }
 
-void
-meta_prop_get_values (MetaX11Display *x11_display,
-                      Window          xwindow,
-                      MetaPropValue  *values,
-                      int             n_values)
+struct _MetaPropRequest
+{
+  MetaX11Display *x11_display;
+  Window xwindow;
+
+  MetaPropValue *values;
+  int n_values;
+
+  xcb_get_property_cookie_t *tasks;
+};
+
+/**
+ * meta_prop_request_values:
+ * @x11_display: the #MetaX11Display
+ * @xwindow: the window to get the properties of
+ * @values: (array length=n_values): the values to fill in
+ * @n_values: the number of values
+ *
+ * Sends the GetProperty requests for @values without waiting for the
+ * replies, so that the caller can do other work while they are in flight.
+ * @values must stay valid until the request is finished with
+ * meta_prop_request_finish() or discarded with meta_prop_request_cancel().
+ *
+ * Returns: (transfer full): the pending request
+ */
+MetaPropRequest *
+meta_prop_request_values (MetaX11Display *x11_display,
+                          Window          xwindow,
+                          MetaPropValue  *values,
+                          int             n_values)
 {
+  MetaPropRequest *request;
   int i;
   xcb_get_property_cookie_t *tasks;
   xcb_connection_t *xcb_conn = XGetXCBConnection (x11_display->xdisplay);
@@ -840,10 +866,17 @@ meta_prop_get_values (MetaX11Display *x11_display,
   meta_verbose ("Requesting %d properties of 0x%lx at once\n",
                 n_values, xwindow);
 
+  request = g_new0 (MetaPropRequest, 1);
+  request->x11_display = x11_display;
+  request->xwindow = xwindow;
+  request->values = values;
+  request->n_values = n_values;
+
   if (n_values == 0)
-    return;
+    return request;
 
   tasks = g_new0 (xcb_get_property_cookie_t, n_values);
+  request->tasks = tasks;
 
   /* Start up tasks. The "values" array can have values
    * with atom == None, which means to ignore that element.
@@ -907,10 +940,35 @@ meta_prop_get_values (MetaX11Display *x11_display,
       ++i;
     }
 
-  /* Get replies for all our tasks */
-  meta_topic (META_DEBUG_SYNC, "Syncing to get %d GetProperty replies in %s\n",
+  xcb_flush (xcb_conn);
+
+  return request;
+}
+
+/**
+ * meta_prop_request_finish:
+ * @request: (transfer full): a request from meta_prop_request_values()
+ *
+ * Waits for the replies of @request and fills in the values it was created
+ * with. Each value that couldn't be fetched comes back as
+ * %META_PROP_VALUE_INVALID. @request is freed.
+ */
+void
+meta_prop_request_finish (MetaPropRequest *request)
+{
+  MetaX11Display *x11_display = request->x11_display;
+  Window xwindow = request->xwindow;
+  MetaPropValue *values = request->values;
+  int n_values = request->n_values;
+  xcb_get_property_cookie_t *tasks = request->tasks;
+  xcb_connection_t *xcb_conn = XGetXCBConnection (x11_display->xdisplay);
+  int i;
+
+  /* Each reply carries its own error, so there is no need to XSync() here;
+   * xcb blocks on the replies that haven't arrived yet.
+   */
+  meta_topic (META_DEBUG_SYNC, "Waiting for %d GetProperty replies in %s\n",
               n_values, G_STRFUNC);
-  XSync (x11_display->xdisplay, False);
 
   /* Collect results, should arrive in order requested */
   i = 0;
@@ -1041,6 +1099,44 @@ meta_prop_get_values (MetaX11Display *x11_display,
     }
 
   g_free (tasks);
+  g_free (request);
+}
+
+/**
+ * meta_prop_request_cancel:
+ * @request: (transfer full): a request from meta_prop_request_values()
+ *
+ * Discards the replies of @request without waiting for them. The values
+ * it was created with are left untouched. @request is freed.
+ */
+void
+meta_prop_request_cancel (MetaPropRequest *request)
+{
+  xcb_connection_t *xcb_conn =
+    XGetXCBConnection (request->x11_display->xdisplay);
+  int i;
+
+  for (i = 0; i < request->n_values; i++)
+    {
+      if (request->tasks[i].sequence != 0)
+        xcb_discard_reply (xcb_conn, request->tasks[i].sequence);
+    }
+
+  g_free (request->tasks);
+  g_free (request);
+}
+
+void
+meta_prop_get_values (MetaX11Display *x11_display,
+                      Window          xwindow,
+                      MetaPropValue  *values,
+                      int             n_values)
+{
+  if (n_values == 0)
+    return;
+
+  meta_prop_request_finish (meta_prop_request_values (x11_display, xwindow,
+                                                      values, n_values));
 }
 
 static void
@@ -176,6 +176,17 @@ typedef struct
 
 } MetaPropValue;
 
+typedef struct _MetaPropRequest MetaPropRequest;
+
+MetaPropRequest * meta_prop_request_values (MetaX11Display *x11_display,
+                                            Window          xwindow,
+                                            MetaPropValue  *values,
+                                            int             n_values);
+
+void meta_prop_request_finish (MetaPropRequest *request);
+
+void meta_prop_request_cancel (MetaPropRequest *request);
+
 /* Each value has type and atom initialized. If there's an error,
  * or property is unset, type comes back as INVALID;
  * else type comes back as it originated, and the data